@@ -17,7 +17,7 @@
   
 #include "addbarline.h"
 
-#include <score/system.h>
+#include <score/score.h>
 
 AddBarline::AddBarline(const ScoreLocation &location, const Barline &barline)
     : QUndoCommand(QObject::tr("Insert Barline")),
@@ -41,9 +41,11 @@ AddBarline::AddBarline(const ScoreLocation &location, const Barline &barline)
 void AddBarline::redo()
 {
     myLocation.getSystem().insertBarline(myBarline);
+    myLocation.getScore().updateIndexes(myLocation.getSystemIndex());
 }
 
 void AddBarline::undo()
 {
     myLocation.getSystem().removeBarline(myBarline);
+    myLocation.getScore().updateIndexes(myLocation.getSystemIndex());
 }
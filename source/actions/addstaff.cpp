@@ -17,7 +17,7 @@
   
 #include "addstaff.h"
 
-#include <score/system.h>
+#include <score/score.h>
 
 AddStaff::AddStaff(const ScoreLocation &location, const Staff &staff, int index)
     : QUndoCommand(QObject::tr("Add Staff")),
@@ -30,9 +30,11 @@ AddStaff::AddStaff(const ScoreLocation &location, const Staff &staff, int index)
 void AddStaff::redo()
 {
     myLocation.getSystem().insertStaff(myStaff, myIndex);
+    myLocation.getScore().updateIndexes(myLocation.getSystemIndex());
 }
 
 void AddStaff::undo()
 {
     myLocation.getSystem().removeStaff(myIndex);
+    myLocation.getScore().updateIndexes(myLocation.getSystemIndex());
 }
@@ -55,6 +55,7 @@ void EditPlayer::redo()
     }
 
     myScore.getPlayers()[myPlayerIndex] = myNewPlayer;
+    myScore.updateIndexes(0);
 }
 
 void EditPlayer::undo()
@@ -76,4 +77,6 @@ void EditPlayer::undo()
 
         myOriginalChanges.clear();
     }
+
+    myScore.updateIndexes(0);
 }
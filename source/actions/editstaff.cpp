@@ -66,6 +66,8 @@ void EditStaff::redo()
 
         staff.setStringCount(myNumStrings);
     }
+
+    myLocation.getScore().updateIndexes(myLocation.getSystemIndex());
 }
 
 void EditStaff::undo()
@@ -76,6 +78,8 @@ void EditStaff::undo()
 
     if (myOriginalNextSystem)
         score.getSystems()[system_index + 1] = *myOriginalNextSystem;
+
+    score.updateIndexes(system_index);
 }
 
 void EditStaff::addPlayerChangeAtStart(Score &score, int system_index)
@@ -91,5 +95,6 @@ void EditStaff::addPlayerChangeAtStart(Score &score, int system_index)
         PlayerChange change(*current_players);
         change.setPosition(0);
         system.insertPlayerChange(change);
+        score.updateIndexes(system_index);
     }
 }
@@ -30,6 +30,7 @@ RemoveBarline::RemoveBarline(const ScoreLocation &location)
 void RemoveBarline::redo()
 {
     myLocation.getSystem().removeBarline(myOriginalBarline);
+    myLocation.getScore().updateIndexes(myLocation.getSystemIndex());
 
     // Update the rehearsal signs letters, since a rehearsal sign may have been
     // removed.
@@ -39,5 +40,6 @@ void RemoveBarline::redo()
 void RemoveBarline::undo()
 {
     myLocation.getSystem().insertBarline(myOriginalBarline);
+    myLocation.getScore().updateIndexes(myLocation.getSystemIndex());
     ScoreUtils::adjustRehearsalSigns(myLocation.getScore());
 }
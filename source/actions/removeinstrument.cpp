@@ -61,6 +61,8 @@ void RemoveInstrument::redo()
             }
         }
     }
+
+    myScore.updateIndexes(0);
 }
 
 void RemoveInstrument::undo()
@@ -77,4 +79,6 @@ void RemoveInstrument::undo()
             ++i;
         }
     }
+
+    myScore.updateIndexes(0);
 }
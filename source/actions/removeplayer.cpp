@@ -61,6 +61,8 @@ void RemovePlayer::redo()
             }
         }
     }
+
+    myScore.updateIndexes(0);
 }
 
 void RemovePlayer::undo()
@@ -77,4 +79,6 @@ void RemovePlayer::undo()
             ++i;
         }
     }
+
+    myScore.updateIndexes(0);
 }
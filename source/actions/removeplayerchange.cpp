@@ -17,7 +17,7 @@
   
 #include "removeplayerchange.h"
 
-#include <score/system.h>
+#include <score/score.h>
 #include <score/utils.h>
 
 RemovePlayerChange::RemovePlayerChange(const ScoreLocation &location)
@@ -32,9 +32,11 @@ RemovePlayerChange::RemovePlayerChange(const ScoreLocation &location)
 void RemovePlayerChange::redo()
 {
     myLocation.getSystem().removePlayerChange(myPlayerChange);
+    myLocation.getScore().updateIndexes(myLocation.getSystemIndex());
 }
 
 void RemovePlayerChange::undo()
 {
     myLocation.getSystem().insertPlayerChange(myPlayerChange);
+    myLocation.getScore().updateIndexes(myLocation.getSystemIndex());
 }
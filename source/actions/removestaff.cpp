@@ -18,7 +18,7 @@
 #include "removestaff.h"
 
 #include <app/caret.h>
-#include <score/system.h>
+#include <score/score.h>
 
 RemoveStaff::RemoveStaff(const ScoreLocation &location)
     : QUndoCommand(QObject::tr("Remove Staff")),
@@ -31,9 +31,11 @@ RemoveStaff::RemoveStaff(const ScoreLocation &location)
 void RemoveStaff::redo()
 {
     myLocation.getSystem().removeStaff(myIndex);
+    myLocation.getScore().updateIndexes(myLocation.getSystemIndex());
 }
 
 void RemoveStaff::undo()
 {
     myLocation.getSystem().insertStaff(myOriginalStaff, myIndex);
+    myLocation.getScore().updateIndexes(myLocation.getSystemIndex());
 }
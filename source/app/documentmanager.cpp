@@ -186,3 +186,8 @@ Caret &Document::getCaret()
 {
     return myCaret;
 }
+
+MidiEventCache &Document::getMidiCache()
+{
+    return myMidiCache;
+}
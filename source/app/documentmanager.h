@@ -22,6 +22,7 @@
 #include <app/caret.h>
 #include <boost/optional/optional.hpp>
 #include <memory>
+#include <midi/midieventcache.h>
 #include <score/score.h>
 #include <vector>
 
@@ -51,11 +52,16 @@ public:
     const Caret &getCaret() const;
     Caret &getCaret();
 
+    /// The MIDI events generated for the score during playback, which must be
+    /// invalidated when the score is modified.
+    MidiEventCache &getMidiCache();
+
 private:
     boost::optional<std::string> myFilename;
     Score myScore;
     ViewOptions myViewOptions;
     Caret myCaret;
+    MidiEventCache myMidiCache;
 };
 
 /// Class for managing open documents.
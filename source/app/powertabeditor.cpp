@@ -587,7 +587,9 @@ void PowerTabEditor::startStopPlayback(bool from_measure_start)
         const ScoreLocation &location = getLocation();
         myMidiPlayer.reset(
             new MidiPlayer(*mySettingsManager, location,
-                           myPlaybackWidget->getPlaybackSpeed()));
+                           myPlaybackWidget->getPlaybackSpeed(),
+                           myDocumentManager->getCurrentDocument()
+                               .getMidiCache()));
 
         connect(myMidiPlayer.get(), SIGNAL(playbackSystemChanged(int)), this,
                 SLOT(moveCaretToSystem(int)));
@@ -625,6 +627,8 @@ void PowerTabEditor::startStopPlayback(bool from_measure_start)
 
 void PowerTabEditor::redrawSystem(int index)
 {
+    myDocumentManager->getCurrentDocument().getMidiCache().invalidateSystem(
+        index);
     getCaret().moveToValidPosition();
     getScoreArea()->redrawSystem(index);
     updateCommands();
@@ -633,6 +637,7 @@ void PowerTabEditor::redrawSystem(int index)
 void PowerTabEditor::redrawScore()
 {
     Document &doc = myDocumentManager->getCurrentDocument();
+    doc.getMidiCache().clear();
     doc.validateViewOptions();
     getCaret().moveToValidPosition();
     getScoreArea()->renderDocument(doc);
@@ -2932,6 +2937,11 @@ void PowerTabEditor::setupNewTab()
     });
 
     auto scorearea = new ScoreArea(this);
+    {
+        auto settings = mySettingsManager->getReadHandle();
+        scorearea->setSystemCacheEnabled(
+            settings->get(Settings::CacheRenderedSystems));
+    }
     scorearea->renderDocument(doc);
     scorearea->installEventFilter(this);
 
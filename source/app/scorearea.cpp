@@ -17,20 +17,50 @@
   
 #include "scorearea.h"
 
+#include <algorithm>
 #include <app/documentmanager.h>
 #include <app/pubsub/clickpubsub.h>
+#include <atomic>
 #include <chrono>
 #include <future>
+#include <iterator>
 #include <painters/caretpainter.h>
 #include <painters/systemrenderer.h>
+#include <painters/textcache.h>
 #include <QDebug>
-#include <QGraphicsItem>
+#include <QFontDatabase>
+#include <QGraphicsEffect>
+#include <QGraphicsRectItem>
 #include <QGraphicsSceneDragDropEvent>
+#include <QPainter>
 #include <QPrinter>
 #include <QScrollBar>
 #include <score/score.h>
+#include <thread>
 
 static const double SYSTEM_SPACING = 50;
+/// The maximum number of systems that are kept rendered when they are not
+/// near the visible area of the score.
+static const int MAX_RENDERED_SYSTEMS = 50;
+
+/// Draws a system and all of its children from a single pixmap. Qt keeps the
+/// pixmap until something in the system changes or the view is zoomed, so
+/// scrolling only needs to copy it to the screen.
+class SystemCacheEffect : public QGraphicsEffect
+{
+protected:
+    virtual void draw(QPainter *painter) override
+    {
+        QPoint offset;
+        const QPixmap pixmap = sourcePixmap(Qt::DeviceCoordinates, &offset,
+                                            QGraphicsEffect::NoPad);
+
+        const QTransform transform = painter->worldTransform();
+        painter->setWorldTransform(QTransform());
+        painter->drawPixmap(offset, pixmap);
+        painter->setWorldTransform(transform);
+    }
+};
 
 void ScoreArea::Scene::dragEnterEvent(QGraphicsSceneDragDropEvent *event)
 {
@@ -39,72 +69,109 @@ void ScoreArea::Scene::dragEnterEvent(QGraphicsSceneDragDropEvent *event)
 
 ScoreArea::ScoreArea(QWidget *parent)
     : QGraphicsView(parent),
+      mySystemOffsets(SYSTEM_SPACING),
+      myPlaceholder(nullptr),
+      mySystemCacheEnabled(false),
       myCaretPainter(nullptr),
       myClickPubSub(std::make_shared<ClickPubSub>())
 {
     setScene(&myScene);
 }
 
+void ScoreArea::setSystemCacheEnabled(bool enabled)
+{
+    mySystemCacheEnabled = enabled;
+
+    for (auto &system : myRenderedSystems)
+        system.second->setGraphicsEffect(enabled ? new SystemCacheEffect()
+                                                 : nullptr);
+}
+
 void ScoreArea::renderDocument(const Document &document)
 {
-    myScene.clear();
     myRenderedSystems.clear();
+    mySystemOffsets.reset({});
+    myScene.clear();
+
+    // The cached layouts can be reused when the same document is redrawn.
+    if (myDocument.get_ptr() != &document)
+        myLayoutCache.clear();
     myDocument = document;
+    const std::pair<int, int> initialLayoutHits = myLayoutCache.getHitCount();
 
     const Score &score = document.getScore();
 
     auto start = std::chrono::high_resolution_clock::now();
 
-    myCaretPainter =
-        new CaretPainter(document.getCaret(), document.getViewOptions());
+    myCaretPainter = new CaretPainter(document.getCaret(),
+                                      document.getViewOptions(),
+                                      mySystemOffsets);
     myCaretPainter->subscribeToMovement([=]() {
         adjustScroll();
     });
 
-    myRenderedSystems.reserve(score.getSystems().size());
-    for (unsigned int i = 0; i < score.getSystems().size(); ++i)
-        myRenderedSystems.append(nullptr);
-
-#if 0
-    const int num_threads = std::thread::hardware_concurrency();
-#else
-    const int num_threads = 1;
-#endif
-    std::vector<std::future<void>> tasks;
-    const int work_size = myRenderedSystems.size() / num_threads;
-    qDebug() << "Using" << num_threads << "worker thread(s)";
-
-    for (int i = 0; i < num_threads; ++i)
+    // Computing the layout of each system is the expensive part of rendering
+    // and does not touch any graphics items, so it can be split across
+    // several threads. Each thread takes the next system that hasn't been
+    // claimed, since some systems are much more expensive than others. The
+    // graphics items must then be created on the GUI thread.
+    // The layout measures text, so if the platform can't use fonts outside of
+    // the GUI thread, everything is done on the GUI thread.
+    const int num_systems = static_cast<int>(score.getSystems().size());
+    int num_threads = 1;
+    if (QFontDatabase::supportsThreadedFontRendering())
     {
-        const int left = i * work_size;
-        const int right = (i == num_threads - 1) ? myRenderedSystems.size()
-                                                 : (i + 1) * work_size;
+        num_threads = std::max(
+            1, std::min<int>(std::thread::hardware_concurrency(), num_systems));
+    }
+    std::vector<SystemRenderer::SystemLayout> layouts(num_systems);
+    std::atomic<int> next_system(0);
+    qDebug() << "Using" << num_threads << "thread(s)";
 
-        tasks.push_back(std::async(std::launch::async, [&](int left, int right)
+    auto computeLayouts = [&]()
+    {
+        for (int i = next_system++; i < num_systems; i = next_system++)
         {
-            for (int i = left; i < right; ++i)
-            {
-                SystemRenderer render(this, score, document.getViewOptions());
-                myRenderedSystems[i] = render(score.getSystems()[i], i);
-            }
-        }, left, right));
-    }
+            layouts[i] = SystemRenderer::computeLayout(
+                score, document.getViewOptions(), score.getSystems()[i], i,
+                &myLayoutCache);
+        }
+    };
+
+    // The GUI thread also takes a share of the systems.
+    std::vector<std::future<void>> tasks;
+    for (int i = 1; i < num_threads; ++i)
+        tasks.push_back(std::async(std::launch::async, computeLayouts));
+
+    computeLayouts();
 
     for (auto &&task : tasks)
         task.get();
 
-    int i = 0;
-    double height = 0;
-    // Layout the systems.
-    for (QGraphicsItem *system : myRenderedSystems)
-    {
-        system->setPos(0, height);
-        myScene.addItem(system);
-        height += system->boundingRect().height() + SYSTEM_SPACING;
-        ++i;
+    auto layout_end = std::chrono::high_resolution_clock::now();
+    qDebug() << "Layout computed in"
+             << std::chrono::duration_cast<std::chrono::milliseconds>(
+                    layout_end - start).count() << "ms";
 
-        myCaretPainter->addSystemRect(system->sceneBoundingRect());
-    }
+    const std::pair<int, int> layoutHits = myLayoutCache.getHitCount();
+    qDebug() << "Layout cache:" << layoutHits.first - initialLayoutHits.first
+             << "of" << layoutHits.second - initialLayoutHits.second
+             << "systems were unchanged";
+
+    // Reserve space for each system. Only the systems near the visible area
+    // are actually rendered.
+    std::vector<double> heights;
+    heights.reserve(num_systems);
+    for (const SystemRenderer::SystemLayout &layout : layouts)
+        heights.push_back(SystemRenderer::getHeight(layout));
+    mySystemOffsets.reset(heights);
+
+    myPlaceholder = new QGraphicsRectItem();
+    myPlaceholder->setPen(Qt::NoPen);
+    myScene.addItem(myPlaceholder);
+    shiftSystems(0);
+
+    updateVisibleSystems(&layouts);
 
     myScene.addItem(myCaretPainter);
 
@@ -112,39 +179,38 @@ void ScoreArea::renderDocument(const Document &document)
     qDebug() << "Score rendered in"
              << std::chrono::duration_cast<std::chrono::milliseconds>(
                     end - start).count() << "ms";
-    qDebug() << "Rendered " << myScene.items().size() << "items";
+    qDebug() << "Rendered" << myRenderedSystems.size() << "of" << num_systems
+             << "systems," << myScene.items().size() << "items";
+
+    const TextCache::Statistics text_stats = TextCache::getStatistics();
+    qDebug() << "Text cache:" << text_stats.myNumEntries << "entries,"
+             << text_stats.myMemoryUsage / 1024 << "KiB,"
+             << 100 * text_stats.getHitRate() << "% hit rate";
 }
 
 void ScoreArea::redrawSystem(int index)
 {
-    // Delete and remove the system from the scene.
-    delete myRenderedSystems.takeAt(index);
-
     const Score &score = myDocument->getScore();
-    SystemRenderer render(this, score, myDocument->getViewOptions());
-    QGraphicsItem *newSystem = render(score.getSystems()[index], index);
+    const System &system = score.getSystems()[index];
+    const SystemRenderer::SystemLayout layout = SystemRenderer::computeLayout(
+        score, myDocument->getViewOptions(), system, index, &myLayoutCache);
 
-    double height = 0;
-    if (index > 0)
+    // Re-render the system if it was visible.
+    auto rendered = myRenderedSystems.find(index);
+    if (rendered != myRenderedSystems.end())
     {
-        height = myRenderedSystems.at(index - 1)->sceneBoundingRect().bottom() +
-                SYSTEM_SPACING;
+        freeSystem(rendered);
+        renderSystem(index, layout);
     }
 
-    newSystem->setPos(0, height);
-    height += newSystem->boundingRect().height() + SYSTEM_SPACING;
-    myCaretPainter->setSystemRect(index, newSystem->sceneBoundingRect());
-
-    myScene.addItem(newSystem);
-    myRenderedSystems.insert(index, newSystem);
-
-    // Shift the following systems.
-    for (int i = index + 1; i < myRenderedSystems.size(); ++i)
+    // If the height of the system changed, the following systems need to be
+    // shifted. Otherwise, nothing else is affected.
+    const double height = SystemRenderer::getHeight(layout);
+    if (height != mySystemOffsets.getHeight(index))
     {
-        QGraphicsItem *system = myRenderedSystems[i];
-        system->setPos(0, height);
-        height += system->boundingRect().height() + SYSTEM_SPACING;
-        myCaretPainter->setSystemRect(i, system->sceneBoundingRect());
+        mySystemOffsets.setHeight(index, height);
+        shiftSystems(index);
+        updateVisibleSystems();
     }
 
     // The spacing may have changed, so update the caret's position and redraw
@@ -160,11 +226,19 @@ void ScoreArea::print(QPrinter &printer)
     // Hide the caret when printing.
     myCaretPainter->hide();
 
+    // Draw the vector graphics rather than the cached pixmaps, which are
+    // only suitable for the screen's resolution.
+    const bool wasCacheEnabled = mySystemCacheEnabled;
+    setSystemCacheEnabled(false);
+
     QRectF target(0, 0, painter.device()->width(), painter.device()->height());
 
-    for (QGraphicsItem *system : myRenderedSystems)
+    const Score &score = myDocument->getScore();
+    for (int i = 0; i < mySystemOffsets.getNumSystems(); ++i)
     {
-        const QRectF source = system->sceneBoundingRect();
+        const QRectF source(0, mySystemOffsets.getTop(i),
+                            LayoutInfo::STAFF_WIDTH,
+                            mySystemOffsets.getHeight(i));
 
         // Figure out how much space the system will take up on the page, and
         // determine if we need a page break.
@@ -177,18 +251,124 @@ void ScoreArea::print(QPrinter &printer)
             target.moveTop(0);
         }
 
+        // Temporarily render the system if it isn't currently visible.
+        const bool wasRendered = myRenderedSystems.count(i) != 0;
+        if (!wasRendered)
+        {
+            renderSystem(i, SystemRenderer::computeLayout(
+                                score, myDocument->getViewOptions(),
+                                score.getSystems()[i], i, &myLayoutCache));
+        }
+
         // Draw the system on the page.
         scene()->render(&painter, target, source);
 
+        if (!wasRendered)
+            freeSystem(myRenderedSystems.find(i));
+
         // Set the location for the next system, and include some padding
         // between systems.
         target.moveTop(target.y() + systemHeight + SYSTEM_SPACING * ratio);
     }
 
+    setSystemCacheEnabled(wasCacheEnabled);
     myCaretPainter->show();
     painter.end();
 }
 
+void ScoreArea::shiftSystems(int index)
+{
+    // Only the rendered systems need to be moved, so this does not depend on
+    // the length of the score.
+    for (auto it = myRenderedSystems.upper_bound(index);
+         it != myRenderedSystems.end(); ++it)
+    {
+        it->second->setPos(0, mySystemOffsets.getTop(it->first));
+    }
+
+    myPlaceholder->setRect(0, 0, LayoutInfo::STAFF_WIDTH,
+                           mySystemOffsets.getTotalHeight());
+}
+
+std::pair<int, int> ScoreArea::findSystems(double top, double bottom) const
+{
+    const int first = mySystemOffsets.findSystem(top);
+
+    int last = mySystemOffsets.findSystem(bottom);
+    if (last < mySystemOffsets.getNumSystems() &&
+        mySystemOffsets.getTop(last) <= bottom)
+    {
+        ++last;
+    }
+
+    return std::make_pair(first, last);
+}
+
+void ScoreArea::updateVisibleSystems(
+    const std::vector<SystemRenderer::SystemLayout> *layouts)
+{
+    if (!myDocument)
+        return;
+
+    // Render the visible systems, along with the systems within one screen
+    // above or below, so that they are ready when scrolling.
+    const QRectF visible = mapToScene(viewport()->rect()).boundingRect();
+    const std::pair<int, int> range = findSystems(
+        visible.top() - visible.height(), visible.bottom() + visible.height());
+
+    const Score &score = myDocument->getScore();
+    for (int i = range.first; i < range.second; ++i)
+    {
+        if (myRenderedSystems.count(i))
+            continue;
+
+        if (layouts)
+            renderSystem(i, (*layouts)[i]);
+        else
+        {
+            renderSystem(i, SystemRenderer::computeLayout(
+                                score, myDocument->getViewOptions(),
+                                score.getSystems()[i], i, &myLayoutCache));
+        }
+    }
+
+    // If there are too many rendered systems, free the ones that are furthest
+    // from the visible area.
+    while (static_cast<int>(myRenderedSystems.size()) > MAX_RENDERED_SYSTEMS)
+    {
+        auto first = myRenderedSystems.begin();
+        auto last = std::prev(myRenderedSystems.end());
+        const int distanceAbove = range.first - first->first;
+        const int distanceBelow = last->first - (range.second - 1);
+        if (distanceAbove <= 0 && distanceBelow <= 0)
+            break;
+
+        freeSystem(distanceAbove >= distanceBelow ? first : last);
+    }
+}
+
+void ScoreArea::renderSystem(int index,
+                             const SystemRenderer::SystemLayout &layout)
+{
+    Q_ASSERT(!myRenderedSystems.count(index));
+
+    const Score &score = myDocument->getScore();
+    SystemRenderer render(this, score, myDocument->getViewOptions());
+    QGraphicsItem *system = render(score.getSystems()[index], index, layout);
+    system->setPos(0, mySystemOffsets.getTop(index));
+    if (mySystemCacheEnabled)
+        system->setGraphicsEffect(new SystemCacheEffect());
+    myScene.addItem(system);
+
+    myRenderedSystems[index] = system;
+}
+
+void ScoreArea::freeSystem(std::map<int, QGraphicsItem *>::iterator system)
+{
+    delete system->second;
+    myRenderedSystems.erase(system);
+}
+
 std::shared_ptr<ClickPubSub> ScoreArea::getClickPubSub() const
 {
     return myClickPubSub;
@@ -206,6 +386,18 @@ void ScoreArea::adjustScroll()
         ensureVisible(myCaretPainter->sceneBoundingRect(), 0, 0);
 }
 
+void ScoreArea::resizeEvent(QResizeEvent *event)
+{
+    QGraphicsView::resizeEvent(event);
+    updateVisibleSystems();
+}
+
+void ScoreArea::scrollContentsBy(int dx, int dy)
+{
+    QGraphicsView::scrollContentsBy(dx, dy);
+    updateVisibleSystems();
+}
+
 void ScoreArea::focusInEvent(QFocusEvent *)
 {
     myScene.update(myCaretPainter->sceneBoundingRect());
@@ -224,4 +416,6 @@ void ScoreArea::zoomTo(double percent)
     QTransform xform;
     xform.scale(scale_factor, scale_factor);
     setTransform(xform);
+
+    updateVisibleSystems();
 }
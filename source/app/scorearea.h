@@ -19,14 +19,21 @@
 #define APP_SCOREAREA_H
 
 #include <boost/optional.hpp>
+#include <map>
 #include <memory>
+#include <painters/layoutcache.h>
+#include <painters/systemoffsets.h>
+#include <painters/systemrenderer.h>
 #include <QGraphicsScene>
 #include <QGraphicsView>
 #include <score/staff.h>
+#include <utility>
+#include <vector>
 
 class CaretPainter;
 class ClickPubSub;
 class Document;
+class QGraphicsRectItem;
 class QPrinter;
 
 /// The visual display of the score.
@@ -50,6 +57,12 @@ public:
 
     void print(QPrinter &printer);
 
+    /// Enables or disables caching each rendered system as a pixmap. The
+    /// pixmaps are regenerated when the zoom level changes or a system is
+    /// redrawn, so scrolling (e.g. during playback) only needs to copy them
+    /// to the screen.
+    void setSystemCacheEnabled(bool enabled);
+
     /// Redraws the specified system, and shifts the following systems as
     /// necessary.
     void redrawSystem(int index);
@@ -59,14 +72,47 @@ public:
 protected:
     virtual void focusInEvent(QFocusEvent *event) override;
     virtual void focusOutEvent(QFocusEvent *event) override;
+    virtual void resizeEvent(QResizeEvent *event) override;
+    virtual void scrollContentsBy(int dx, int dy) override;
 
 private:
     /// Adjusts the scroll location whenever the caret moves.
     void adjustScroll();
 
+    /// Moves the rendered systems after the given system to their current
+    /// offsets, and resizes the placeholder to fit the score.
+    void shiftSystems(int index);
+
+    /// Returns the range [first, last) of systems that intersect the given
+    /// vertical range of the scene.
+    std::pair<int, int> findSystems(double top, double bottom) const;
+
+    /// Renders the systems that are near the visible area of the score, and
+    /// frees rendered systems that are far away if there are too many. If
+    /// the systems' layouts have already been computed, they can be provided
+    /// to avoid recomputing them.
+    void updateVisibleSystems(
+        const std::vector<SystemRenderer::SystemLayout> *layouts = nullptr);
+
+    /// Creates the graphics items for a system.
+    void renderSystem(int index, const SystemRenderer::SystemLayout &layout);
+
+    /// Deletes the graphics items for a system.
+    void freeSystem(std::map<int, QGraphicsItem *>::iterator system);
+
     Scene myScene;
     boost::optional<const Document &> myDocument;
-    QList<QGraphicsItem *> myRenderedSystems;
+    /// The position and height of each system, whether or not it is rendered.
+    SystemOffsets mySystemOffsets;
+    /// An empty item spanning the entire score, which reserves space in the
+    /// scene for the systems that are not rendered.
+    QGraphicsRectItem *myPlaceholder;
+    /// The layouts of the systems from previous renders, which are reused
+    /// for systems that have not changed.
+    LayoutCache myLayoutCache;
+    /// The graphics items for the systems that are currently rendered.
+    std::map<int, QGraphicsItem *> myRenderedSystems;
+    bool mySystemCacheEnabled;
     CaretPainter *myCaretPainter;
 
     std::shared_ptr<ClickPubSub> myClickPubSub;
@@ -30,6 +30,7 @@ namespace Settings
     extern const Setting<QByteArray> WindowState;
     extern const Setting<std::vector<std::string>> RecentFiles;
     extern const Setting<bool> OpenFilesInNewWindow;
+    extern const Setting<bool> CacheRenderedSystems;
 
     extern const Setting<std::string> DefaultInstrumentName;
     extern const Setting<int> DefaultInstrumentPreset;
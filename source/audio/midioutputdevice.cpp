@@ -51,11 +51,12 @@ MidiOutputDevice::~MidiOutputDevice()
 {
 }
 
-void
-MidiOutputDevice::sendMessage(const std::vector<uint8_t> &data)
+void MidiOutputDevice::sendMessage(
+    const boost::iterator_range<const uint8_t *> &data)
 {
-    // FIXME - fix const correctness in RtMidi api.
-    myMidiOut->sendMessage(const_cast<std::vector<uint8_t> *>(&data));
+    // RtMidi requires a vector, so copy the data into a reusable buffer.
+    myMessage.assign(data.begin(), data.end());
+    myMidiOut->sendMessage(&myMessage);
 }
 
 bool MidiOutputDevice::sendMidiMessage(unsigned char a, unsigned char b,
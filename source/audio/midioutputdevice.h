@@ -26,6 +26,7 @@
 **/
 
 #include <array>
+#include <boost/range/iterator_range_core.hpp>
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -82,7 +83,7 @@ public:
         RpnMsb = 101
     };
 
-    void sendMessage(const std::vector<uint8_t> &data);
+    void sendMessage(const boost::iterator_range<const uint8_t *> &data);
 
 private:
     bool sendMidiMessage(unsigned char a, unsigned char b, unsigned char c);
@@ -93,6 +94,8 @@ private:
     std::array<uint8_t, NUM_CHANNELS> myMaxVolumes;
     /// Volume of last active dynamic for each channel.
     std::array<uint8_t, NUM_CHANNELS> myActiveVolumes;
+    /// Buffer for sending messages, which is reused to avoid allocations.
+    std::vector<uint8_t> myMessage;
 };
 
 #endif
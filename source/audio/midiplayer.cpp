@@ -22,9 +22,15 @@
 #include <audio/settings.h>
 #include <boost/rational.hpp>
 #include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <midi/midieventcache.h>
 #include <midi/midifile.h>
+#include <midi/settings.h>
+#include <QDebug>
 #include <score/generalmidi.h>
 #include <score/score.h>
+#include <thread>
 
 #ifdef _WIN32
 #include <boost/scope_exit.hpp>
@@ -33,10 +39,113 @@
 
 static const int METRONOME_CHANNEL = 9;
 
+namespace
+{
+/// Schedules events against a monotonic clock. Each deadline is computed
+/// from the song time at which playback (or the latest change in playback
+/// speed) began, rather than from the previous event, so that any error in
+/// waking up does not accumulate over the course of the song.
+class PlaybackClock
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    explicit PlaybackClock(int ticks_per_beat)
+        : myTicksPerBeat(ticks_per_beat),
+          mySongTime(0),
+          myLastSongTime(0),
+          myAnchorSongTime(0),
+          mySpeed(100),
+          myNumWakeups(0),
+          myTotalLateness(0),
+          myMaxLateness(0),
+          myLastLateness(0)
+    {
+    }
+
+    /// Starts the clock, with the current song time occurring now.
+    void start(int speed)
+    {
+        mySpeed = speed;
+        myAnchorSongTime = myLastSongTime = mySongTime;
+        myAnchorTime = Clock::now();
+    }
+
+    /// Advances the song time by the given number of ticks.
+    void advance(int ticks, int beat_duration)
+    {
+        mySongTime += static_cast<int64_t>(ticks) * beat_duration;
+    }
+
+    /// Sleeps until the current song time is reached. If the playback speed
+    /// has changed, the following deadlines are computed relative to the
+    /// previous deadline.
+    void waitUntilDue(int speed)
+    {
+        if (speed != mySpeed)
+        {
+            myAnchorTime = getDeadline(myLastSongTime);
+            myAnchorSongTime = myLastSongTime;
+            mySpeed = speed;
+        }
+
+        const Clock::time_point deadline = getDeadline(mySongTime);
+        std::this_thread::sleep_until(deadline);
+
+        const double lateness =
+            std::chrono::duration<double, std::micro>(Clock::now() - deadline)
+                .count();
+        ++myNumWakeups;
+        myTotalLateness += lateness;
+        myMaxLateness = std::max(myMaxLateness, lateness);
+        myLastLateness = lateness;
+        myLastSongTime = mySongTime;
+    }
+
+    void printStatistics() const
+    {
+        if (myNumWakeups == 0)
+            return;
+
+        qDebug() << "Playback timing:" << myNumWakeups << "wakeups, mean"
+                 << myTotalLateness / myNumWakeups << "us late, max"
+                 << myMaxLateness << "us late, drift at end" << myLastLateness
+                 << "us";
+    }
+
+private:
+    /// Returns the time at which the given song time should occur.
+    Clock::time_point getDeadline(int64_t song_time) const
+    {
+        const double elapsed_us = (song_time - myAnchorSongTime) *
+                                  (100.0 / mySpeed) / myTicksPerBeat;
+        return myAnchorTime +
+               std::chrono::duration_cast<Clock::duration>(
+                   std::chrono::duration<double, std::micro>(elapsed_us));
+    }
+
+    const int myTicksPerBeat;
+    /// The song time, in microseconds * ticks per beat.
+    int64_t mySongTime;
+    /// The song time of the previous deadline.
+    int64_t myLastSongTime;
+    int64_t myAnchorSongTime;
+    Clock::time_point myAnchorTime;
+    int mySpeed;
+
+    int myNumWakeups;
+    double myTotalLateness;
+    double myMaxLateness;
+    double myLastLateness;
+};
+}
+
 MidiPlayer::MidiPlayer(SettingsManager &settings_manager,
-                       const ScoreLocation &start_location, int speed)
+                       const ScoreLocation &start_location, int speed,
+                       MidiEventCache &cache)
     : mySettingsManager(settings_manager),
       myScore(start_location.getScore()),
+      myCache(cache),
       myStartLocation(start_location),
       myIsPlaying(false),
       myPlaybackSpeed(speed)
@@ -92,23 +201,18 @@ void MidiPlayer::run()
             settings->get(Settings::MidiWideVibratoLevel);
     }
 
-    MidiFile file;
-    file.load(myScore, options);
+    // Generate the MIDI events incrementally while playing, so that playback
+    // can start immediately for long scores. Generation begins at the bar
+    // containing the start location, and bars that haven't been edited since
+    // the last playback are reused from the cache.
+    const std::pair<int, int> initial_hits = myCache.getHitCount();
+    const SystemLocation start_location(myStartLocation.getSystemIndex(),
+                                        myStartLocation.getPositionIndex());
 
+    MidiFile file;
+    file.beginLoad(myScore, options, &myCache, start_location);
     const int ticks_per_beat = file.getTicksPerBeat();
 
-    // Merge the MIDI evvents for each track.
-    MidiEventList events;
-    for (MidiEventList &track : file.getTracks())
-    {
-        track.convertToAbsoluteTicks();
-        events.concat(track);
-    }
-
-    // TODO - since each track is already sorted, an n-way merge should be faster.
-    std::stable_sort(events.begin(), events.end());
-    events.convertToDeltaTicks();
-
     // Initialize RtMidi and set the port.
     MidiOutputDevice device;
     if (!device.initialize(api, port))
@@ -119,71 +223,97 @@ void MidiPlayer::run()
 
     bool started = false;
     int beat_duration = Midi::BEAT_DURATION_120_BPM;
-    const SystemLocation start_location(myStartLocation.getSystemIndex(),
-                                        myStartLocation.getPositionIndex());
+    PlaybackClock clock(ticks_per_beat);
     SystemLocation current_location = start_location;
 
-    for (auto event = events.begin(); event != events.end(); ++event)
-    {
-        if (!isPlaying())
-            break;
+    int prev_ticks = 0;
+    bool more_bars = true;
 
-        if (event->isTempoChange())
-            beat_duration = event->getTempo();
+    while (more_bars && isPlaying())
+    {
+        // Generate the next bar, and play any events that are complete.
+        MidiEventList events;
+        more_bars = file.loadNextBar();
+        file.takeCompletedEvents(events);
 
-        // Skip events before the start location, except for events such as
-        // instrument changes. Tempo changes are tracked above.
-        if (!started)
+        for (auto event = events.begin(); event != events.end(); ++event)
         {
-            if (event->getLocation() < start_location)
-            {
-                if (event->isProgramChange())
-                    device.sendMessage(event->getData());
+            if (!isPlaying())
+                break;
 
-                continue;
-            }
-            else
+            if (event->isTempoChange())
+                beat_duration = event->getTempo();
+
+            // Skip the events earlier in the first bar, except for events such
+            // as instrument changes. Tempo changes are tracked above.
+            if (!started)
             {
-                performCountIn(device, event->getLocation(), beat_duration);
+                if (event->getLocation() < start_location)
+                {
+                    if (event->isProgramChange())
+                        device.sendMessage(event->getData());
 
-                started = true;
+                    prev_ticks = event->getTicks();
+                    continue;
+                }
+                else
+                {
+                    performCountIn(device, event->getLocation(), beat_duration);
+
+                    clock.start(myPlaybackSpeed);
+                    started = true;
+                }
             }
-        }
 
-        const int delta = event->getTicks();
-        assert(delta >= 0);
+            const int delta = event->getTicks() - prev_ticks;
+            assert(delta >= 0);
+            prev_ticks = event->getTicks();
 
-        const int duration_us = boost::rational_cast<int>(
-            boost::rational<int>(delta, ticks_per_beat) * beat_duration);
-
-        usleep(duration_us * (100.0 / myPlaybackSpeed));
+            // Events at the same tick are sent together, without waiting again.
+            if (delta > 0)
+            {
+                clock.advance(delta, beat_duration);
+                clock.waitUntilDue(myPlaybackSpeed);
+            }
 
-        // Don't play metronome events if the metronome is disabled.
-        if (event->isNoteOnOff() && event->getChannel() == METRONOME_CHANNEL &&
-            !myMetronomeEnabled)
-        {
-            continue;
-        }
+            // Don't play metronome events if the metronome is disabled.
+            if (event->isNoteOnOff() &&
+                event->getChannel() == METRONOME_CHANNEL &&
+                !myMetronomeEnabled)
+            {
+                continue;
+            }
 
-        device.sendMessage(event->getData());
+            device.sendMessage(event->getData());
 
-        // Notify listeners of the current playback position.
-        if (event->getLocation() != current_location)
-        {
-            const SystemLocation &new_location = event->getLocation();
+            // Notify listeners of the current playback position.
+            if (event->getLocation() != current_location)
+            {
+                const SystemLocation &new_location = event->getLocation();
 
-            // Don't move backwards unless a repeat occurred.
-            if (new_location < current_location && !event->isPositionChange())
+                // Don't move backwards unless a repeat occurred.
+                if (new_location < current_location &&
+                    !event->isPositionChange())
+                {
                     continue;
+                }
 
-            if (new_location.getSystem() != current_location.getSystem())
-                emit playbackSystemChanged(new_location.getSystem());
+                if (new_location.getSystem() != current_location.getSystem())
+                    emit playbackSystemChanged(new_location.getSystem());
 
-            emit playbackPositionChanged(new_location.getPosition());
+                emit playbackPositionChanged(new_location.getPosition());
 
-            current_location = new_location;
+                current_location = new_location;
+            }
         }
     }
+
+    clock.printStatistics();
+
+    const std::pair<int, int> hits = myCache.getHitCount();
+    qDebug() << "Reused" << hits.first - initial_hits.first << "of"
+             << hits.second - initial_hits.second
+             << "bars from the MIDI event cache";
 }
 
 void MidiPlayer::performCountIn(MidiOutputDevice &device,
@@ -221,13 +351,18 @@ void MidiPlayer::performCountIn(MidiOutputDevice &device,
     device.setChannelMaxVolume(METRONOME_CHANNEL,
                                Midi::MAX_MIDI_CHANNEL_VOLUME);
 
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point deadline = Clock::now();
     for (int i = 0; i < time_sig.getNumPulses(); ++i)
     {
         if (!isPlaying())
             break;
 
         device.playNote(METRONOME_CHANNEL, preset, velocity);
-        usleep(tick_duration * (100.0 / myPlaybackSpeed));
+        deadline += std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double, std::micro>(
+                tick_duration * (100.0 / myPlaybackSpeed)));
+        std::this_thread::sleep_until(deadline);
         device.stopNote(METRONOME_CHANNEL, preset);
     }
 }
@@ -22,6 +22,7 @@
 #include <QThread>
 #include <score/scorelocation.h>
 
+class MidiEventCache;
 class MidiFile;
 class MidiOutputDevice;
 class Score;
@@ -34,7 +35,8 @@ class MidiPlayer : public QThread
 
 public:
     MidiPlayer(SettingsManager &settings_manager,
-               const ScoreLocation &start_location, int speed);
+               const ScoreLocation &start_location, int speed,
+               MidiEventCache &cache);
     ~MidiPlayer();
 
     void changePlaybackSpeed(int new_speed);
@@ -59,6 +61,7 @@ private:
 
     SettingsManager &mySettingsManager;
     const Score &myScore;
+    MidiEventCache &myCache;
     ScoreLocation myStartLocation;
     std::atomic<bool> myIsPlaying;
     std::atomic<bool> myMetronomeEnabled;
@@ -25,19 +25,8 @@ const Setting<int> MidiApi("midi/api", 0);
 
 const Setting<int> MidiPort("midi/port", 0);
 
-const Setting<int> MidiVibratoLevel("midi/vibrato_level", 85);
-
-const Setting<int> MidiWideVibratoLevel("midi/wide_vibrato_level", 127);
-
 const Setting<bool> MetronomeEnabled("midi/metronome_enabled", true);
 
-const Setting<int> MetronomePreset("midi/metronome_preset",
-                                   Midi::MIDI_PERCUSSION_PRESET_HI_WOOD_BLOCK);
-
-const Setting<int> MetronomeStrongAccent("midi/metronome_strong_accent", 127);
-
-const Setting<int> MetronomeWeakAccent("midi/metronome_weak_accent", 80);
-
 const Setting<bool> CountInEnabled("midi/count_in_enabled", true);
 
 const Setting<int> CountInPreset("midi/count_in_preset",
@@ -26,13 +26,7 @@ namespace Settings
     extern const Setting<int> MidiApi;
     extern const Setting<int> MidiPort;
 
-    extern const Setting<int> MidiVibratoLevel;
-    extern const Setting<int> MidiWideVibratoLevel;
-
     extern const Setting<bool> MetronomeEnabled;
-    extern const Setting<int> MetronomePreset;
-    extern const Setting<int> MetronomeStrongAccent;
-    extern const Setting<int> MetronomeWeakAccent;
 
     extern const Setting<bool> CountInEnabled;
     extern const Setting<int> CountInPreset;
@@ -0,0 +1,248 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+#include <app/settingsmanager.h>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <formats/batchconverter.h>
+#include <formats/fileformatmanager.h>
+#include <formats/settings.h>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = boost::filesystem;
+
+/// Converts files without opening the editor.
+class Converter
+{
+public:
+    Converter(const std::string &extension, const fs::path &output_dir)
+        : myExtension(extension),
+          myOutputDir(output_dir),
+          myFormatManager(mySettingsManager),
+          myTotalBytes(0)
+    {
+    }
+
+    /// Saves .pt2 files with the binary archive instead of JSON.
+    void enableBinaryDocuments()
+    {
+        auto settings = mySettingsManager.getWriteHandle();
+        settings->set(Settings::SaveBinaryDocuments, true);
+    }
+
+    /// Adds a file to be converted, or every supported file in a directory.
+    void add(const fs::path &input)
+    {
+        if (!fs::is_directory(input))
+        {
+            addFile(input, input.filename());
+            return;
+        }
+
+        for (fs::recursive_directory_iterator it(input), end; it != end; ++it)
+        {
+            const fs::path &file = it->path();
+            if (!fs::is_regular_file(file) ||
+                !myFormatManager.findFormat(getExtension(file)))
+            {
+                continue;
+            }
+
+            addFile(file, BatchConverter::getRelativePath(input.string(),
+                                                        file.string()));
+        }
+    }
+
+    /// Converts the files and prints a summary.
+    /// @returns Whether all of the files were converted successfully.
+    bool run(int num_threads)
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        std::cout << "Converting " << myJobs.size() << " file(s) using "
+                  << num_threads << " thread(s)" << std::endl;
+
+        size_t num_finished = 0;
+        const Clock::time_point start = Clock::now();
+
+        BatchConverter converter(mySettingsManager);
+        std::vector<BatchConverter::Result> results = converter.run(
+            myJobs, num_threads,
+            [&](const BatchConverter::Job &job,
+                const BatchConverter::Result &result) {
+                ++num_finished;
+                std::cout << "[" << num_finished << "/" << myJobs.size()
+                          << "] " << std::fixed << std::setprecision(1)
+                          << std::setw(8)
+                          << result.myElapsedTime.count() / 1000.0 << " ms  "
+                          << job.mySource;
+
+                if (result.mySuccess)
+                    std::cout << " -> " << job.myDestination << std::endl;
+                else
+                    std::cout << "  FAILED: " << result.myError << std::endl;
+            });
+
+        const double seconds =
+            std::chrono::duration<double>(Clock::now() - start).count();
+
+        size_t num_failed = 0;
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            if (!results[i].mySuccess)
+                ++num_failed;
+        }
+
+        std::cout << std::endl
+                  << "Converted " << results.size() - num_failed << " of "
+                  << results.size() << " file(s) in " << std::setprecision(2)
+                  << seconds << " s" << std::endl;
+
+        if (seconds > 0)
+        {
+            std::cout << "Throughput: " << results.size() / seconds
+                      << " files/s, " << myTotalBytes / seconds / (1 << 20)
+                      << " MB/s" << std::endl;
+        }
+
+        if (num_failed > 0)
+        {
+            std::cout << std::endl << num_failed << " failure(s):" << std::endl;
+            for (size_t i = 0; i < results.size(); ++i)
+            {
+                if (!results[i].mySuccess)
+                {
+                    std::cout << "  " << myJobs[i].mySource << ": "
+                              << results[i].myError << std::endl;
+                }
+            }
+        }
+
+        return num_failed == 0;
+    }
+
+private:
+    static std::string getExtension(const fs::path &file)
+    {
+        // Remove the leading '.'.
+        const std::string extension = file.extension().string();
+        return extension.empty() ? extension : extension.substr(1);
+    }
+
+    /// Adds a file, which will be written to the given path relative to the
+    /// output directory.
+    void addFile(const fs::path &input, fs::path output)
+    {
+        output.replace_extension(myExtension);
+        if (myOutputDir.empty())
+            output = input.parent_path() / output.filename();
+        else
+            output = myOutputDir / output;
+
+        // Don't overwrite an input file with itself.
+        if (fs::exists(output) && fs::equivalent(input, output))
+            return;
+
+        if (output.has_parent_path())
+            fs::create_directories(output.parent_path());
+
+        if (fs::is_regular_file(input))
+            myTotalBytes += fs::file_size(input);
+
+        myJobs.emplace_back(input.string(), output.string());
+    }
+
+    const std::string myExtension;
+    const fs::path myOutputDir;
+    SettingsManager mySettingsManager;
+    FileFormatManager myFormatManager;
+    std::vector<BatchConverter::Job> myJobs;
+    uintmax_t myTotalBytes;
+};
+
+int main(int argc, char *argv[])
+{
+    namespace po = boost::program_options;
+    po::options_description desc(
+        "Usage: pteconvert [options] files...\nConverts files or directories "
+        "of files between formats, without opening the editor.\n\nOptions");
+
+    try
+    {
+        desc.add_options()
+            ("help,h", "Displays this help.")
+            ("format,f", po::value<std::string>()->default_value("pt2"),
+             "The extension of the output format.")
+            ("output,o", po::value<std::string>(),
+             "The directory to write the converted files to. By default, "
+             "each file is written next to the original.")
+            ("binary,b", "Saves .pt2 files in a binary format, which loads "
+             "faster but cannot be opened by older releases.")
+            ("jobs,j", po::value<int>()->default_value(std::max(
+                 1, static_cast<int>(std::thread::hardware_concurrency()))),
+             "The number of files to convert in parallel.")
+            ("files", po::value<std::vector<std::string>>(),
+             "The files or directories to convert.");
+        po::positional_options_description p;
+        p.add("files", -1);
+        po::variables_map vm;
+        po::store(po::command_line_parser(argc, argv)
+                      .options(desc)
+                      .positional(p)
+                      .run(),
+                  vm);
+        po::notify(vm);
+
+        if (vm.count("help") || !vm.count("files"))
+        {
+            std::cout << desc << std::endl;
+            return vm.count("help") ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+
+        fs::path output_dir;
+        if (vm.count("output"))
+            output_dir = vm["output"].as<std::string>();
+
+        Converter converter(vm["format"].as<std::string>(), output_dir);
+        if (vm.count("binary"))
+            converter.enableBinaryDocuments();
+
+        for (auto &file : vm["files"].as<std::vector<std::string>>())
+            converter.add(file);
+
+        return converter.run(std::max(1, vm["jobs"].as<int>()))
+                   ? EXIT_SUCCESS
+                   : EXIT_FAILURE;
+    }
+    catch (po::error &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl << std::endl;
+        std::cerr << desc << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (const fs::filesystem_error &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -22,25 +22,14 @@
 
 GoToBarlineDialog::GoToBarlineDialog(QWidget *parent, const Score &score)
     : QDialog(parent),
-      ui(new Ui::GoToBarlineDialog)
+      ui(new Ui::GoToBarlineDialog),
+      myScore(score)
 {
     ui->setupUi(this);
 
-    for (unsigned long systemIndex = 0; systemIndex < score.getSystems().size();
-         ++systemIndex)
-    {
-        const System &system = score.getSystems()[systemIndex];
-        // Index all barlines except for the end bar.
-        for (unsigned long i = 0; i < system.getBarlines().size() - 1; ++i)
-        {
-            myLocations.push_back(ScoreLocation(
-                score, systemIndex, 0, system.getBarlines()[i].getPosition()));
-        }
-    }
-
     ui->barlineSpinBox->setValue(1);
     ui->barlineSpinBox->setMinimum(1);
-    ui->barlineSpinBox->setMaximum(static_cast<int>(myLocations.size()));
+    ui->barlineSpinBox->setMaximum(score.getBarNumberIndex().getNumBars());
 
     ui->barlineSpinBox->selectAll();
 }
@@ -53,6 +42,8 @@ GoToBarlineDialog::~GoToBarlineDialog()
 /// Returns the location of the selected barline.
 ScoreLocation GoToBarlineDialog::getLocation() const
 {
-    const int index = ui->barlineSpinBox->value();
-    return myLocations.at(index - 1);
+    const SystemLocation location = myScore.getBarNumberIndex().findBar(
+        myScore, ui->barlineSpinBox->value());
+    return ScoreLocation(myScore, location.getSystem(), 0,
+                         location.getPosition());
 }
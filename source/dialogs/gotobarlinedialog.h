@@ -20,7 +20,6 @@
 
 #include <QDialog>
 #include <score/scorelocation.h>
-#include <vector>
 
 namespace Ui {
 class GoToBarlineDialog;
@@ -39,7 +38,7 @@ public:
 
 private:
     Ui::GoToBarlineDialog *ui;
-    std::vector<ScoreLocation> myLocations;
+    const Score &myScore;
 };
 
 #endif
@@ -24,6 +24,7 @@
 #include <audio/settings.h>
 #include <boost/lexical_cast.hpp>
 #include <dialogs/tuningdialog.h>
+#include <midi/settings.h>
 #include <score/generalmidi.h>
 
 typedef std::pair<int, int> MidiApiAndPort;
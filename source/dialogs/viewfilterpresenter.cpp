@@ -93,7 +93,7 @@ void ViewFilterPresenter::removeRule(int index)
 
 void ViewFilterPresenter::editRule(int index, const FilterRule &rule)
 {
-    myFilters[*mySelection].getRules()[index] = rule;
+    myFilters[*mySelection].setRule(index, rule);
     updateView();
 }
 
@@ -0,0 +1,181 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#include "batchconverter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <boost/filesystem.hpp>
+#include <formats/fileformatmanager.h>
+#include <future>
+#include <mutex>
+#include <score/score.h>
+#include <stdexcept>
+#include <unordered_map>
+
+/// Returns the extension of the given path (e.g. "gp5" for "dir/file.gp5").
+static std::string getExtension(const std::string &path)
+{
+    const size_t pos = path.find_last_of("./\\");
+    if (pos == std::string::npos || path[pos] != '.')
+        return std::string();
+
+    return path.substr(pos + 1);
+}
+
+static BatchConverter::Result convertFile(FileFormatManager &manager,
+                                          const BatchConverter::Job &job)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    BatchConverter::Result result;
+    const Clock::time_point start = Clock::now();
+
+    boost::optional<FileFormat> import_format =
+        manager.findFormat(getExtension(job.mySource));
+    boost::optional<FileFormat> export_format =
+        manager.findFormat(getExtension(job.myDestination));
+
+    if (!import_format || !export_format)
+        result.myError = "Unsupported file type.";
+    else
+    {
+        try
+        {
+            Score score;
+            manager.importFile(score, job.mySource, *import_format);
+            manager.exportFile(score, job.myDestination, *export_format);
+            result.mySuccess = true;
+        }
+        catch (const std::exception &e)
+        {
+            result.myError = e.what();
+        }
+    }
+
+    result.myElapsedTime =
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() -
+                                                              start);
+    return result;
+}
+
+BatchConverter::Job::Job(const std::string &source,
+                         const std::string &destination)
+    : mySource(source), myDestination(destination)
+{
+}
+
+BatchConverter::Result::Result() : mySuccess(false), myElapsedTime(0)
+{
+}
+
+BatchConverter::BatchConverter(const SettingsManager &settings_manager)
+    : mySettingsManager(settings_manager)
+{
+}
+
+std::vector<BatchConverter::Result> BatchConverter::run(
+    const std::vector<Job> &jobs, int num_threads,
+    const Callback &callback) const
+{
+    std::vector<Result> results(jobs.size());
+
+    // Jobs that would write to the same file (e.g. song.gp5 and song.ptb both
+    // converting to song.pt2) fail instead of overwriting each other.
+    std::unordered_map<std::string, int> num_writers;
+    for (const Job &job : jobs)
+        ++num_writers[job.myDestination];
+
+    std::vector<bool> conflicts(jobs.size());
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        if (num_writers[jobs[i].myDestination] > 1)
+        {
+            conflicts[i] = true;
+            results[i].myError = "Another file is also converted to " +
+                                 jobs[i].myDestination + ".";
+        }
+    }
+
+    std::atomic<size_t> next_job(0);
+    std::mutex callback_mutex;
+
+    // Each thread takes the next unclaimed file from the list, so a few large
+    // files don't hold up the rest of the work. The importers and exporters
+    // are not shared between threads.
+    auto worker = [&]()
+    {
+        FileFormatManager manager(mySettingsManager);
+
+        for (size_t i = next_job++; i < jobs.size(); i = next_job++)
+        {
+            if (!conflicts[i])
+                results[i] = convertFile(manager, jobs[i]);
+
+            if (callback)
+            {
+                std::lock_guard<std::mutex> lock(callback_mutex);
+                callback(jobs[i], results[i]);
+            }
+        }
+    };
+
+    num_threads = std::max(
+        1, std::min(num_threads, static_cast<int>(jobs.size())));
+
+    std::vector<std::future<void>> tasks;
+    for (int i = 0; i < num_threads; ++i)
+        tasks.push_back(std::async(std::launch::async, worker));
+
+    for (auto &&task : tasks)
+        task.get();
+
+    return results;
+}
+
+std::string BatchConverter::getRelativePath(const std::string &dir,
+                                            const std::string &file)
+{
+    namespace fs = boost::filesystem;
+    const fs::path dir_path(dir);
+    const fs::path file_path(file);
+
+    // Ignore "." components, which also appear for a trailing separator
+    // (e.g. "songs/" is iterated as "songs", ".").
+    auto skipDots = [](fs::path::iterator it, fs::path::iterator end) {
+        while (it != end && *it == ".")
+            ++it;
+        return it;
+    };
+
+    auto dir_it = skipDots(dir_path.begin(), dir_path.end());
+    auto file_it = skipDots(file_path.begin(), file_path.end());
+    while (dir_it != dir_path.end())
+    {
+        if (file_it == file_path.end() || *file_it != *dir_it)
+            throw std::invalid_argument(file + " is not inside " + dir);
+
+        dir_it = skipDots(++dir_it, dir_path.end());
+        file_it = skipDots(++file_it, file_path.end());
+    }
+
+    fs::path relative;
+    for (; file_it != file_path.end(); ++file_it)
+        relative /= *file_it;
+
+    return relative.string();
+}
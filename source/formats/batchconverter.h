@@ -0,0 +1,77 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#ifndef FORMATS_BATCHCONVERTER_H
+#define FORMATS_BATCHCONVERTER_H
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+class SettingsManager;
+
+/// Converts a list of files between formats on a pool of worker threads,
+/// without requiring the GUI (e.g. for converting an archive of files to the
+/// .pt2 format).
+class BatchConverter
+{
+public:
+    struct Job
+    {
+        Job(const std::string &source, const std::string &destination);
+
+        std::string mySource;
+        std::string myDestination;
+    };
+
+    struct Result
+    {
+        Result();
+
+        /// Whether the file was imported and exported successfully.
+        bool mySuccess;
+        /// Describes the reason that the conversion failed.
+        std::string myError;
+        /// Time taken to import and export the file.
+        std::chrono::microseconds myElapsedTime;
+    };
+
+    /// Invoked after each file is converted. Only one thread at a time will
+    /// invoke the callback.
+    typedef std::function<void(const Job &, const Result &)> Callback;
+
+    BatchConverter(const SettingsManager &settings_manager);
+
+    /// Converts each file, using up to the given number of threads. The
+    /// format of each file is determined from its extension. Jobs that share
+    /// a destination are not converted, and are reported as failures.
+    /// @returns The result of each job, in the same order as the jobs.
+    std::vector<Result> run(const std::vector<Job> &jobs, int num_threads,
+                            const Callback &callback = Callback()) const;
+
+    /// Returns the path of the file relative to the given directory, which
+    /// must be one of its parent directories (e.g. for finding where to
+    /// write a file that was found when searching the directory).
+    static std::string getRelativePath(const std::string &dir,
+                                       const std::string &file);
+
+private:
+    const SettingsManager &mySettingsManager;
+};
+
+#endif
@@ -31,7 +31,7 @@ FileFormatManager::FileFormatManager(const SettingsManager &settings_manager)
     myImporters.emplace_back(new GuitarProImporter());
     myImporters.emplace_back(new GpxImporter());
 
-    myExporters.emplace_back(new PowerTabExporter());
+    myExporters.emplace_back(new PowerTabExporter(settings_manager));
     myExporters.emplace_back(new MidiExporter(settings_manager));
 }
 
@@ -17,14 +17,16 @@
   
 #include "bitstream.h"
 
+#include <algorithm>
 #include <cassert>
 #include <istream>
 #include "util.h"
 
 static const uint32_t BYTE_LENGTH = 8;
+static const int BUFFER_LENGTH = 64;
 
 Gpx::BitStream::BitStream(std::istream &stream)
-    : myPosition(0)
+    : myPosition(0), myNextByte(0), myBuffer(0), myBufferSize(0)
 {
     // Copy data from the stream into an internal buffer.
     stream.seekg(0, std::ios::end);
@@ -41,39 +43,58 @@ uint32_t Gpx::BitStream::readInt()
     const uint32_t value = Gpx::Util::readUInt(myBytes,
                                                myPosition / BYTE_LENGTH);
     myPosition += sizeof(uint32_t) * BYTE_LENGTH;
+
+    // Discard any buffered bits and continue reading after the integer.
+    myNextByte = myPosition / BYTE_LENGTH;
+    myBuffer = 0;
+    myBufferSize = 0;
+
     return value;
 }
 
 bool Gpx::BitStream::readBit()
 {
-    if (myPosition / BYTE_LENGTH >= myBytes.size())
-        return 0;
-
-    char byte = myBytes[myPosition / BYTE_LENGTH];
-    byte >>= ((BYTE_LENGTH - 1) - (myPosition % BYTE_LENGTH));
-    byte &= 0x01;
+    return readBits(1) != 0;
+}
 
-    ++myPosition;
+void Gpx::BitStream::refill()
+{
+    const int byteLength = BYTE_LENGTH;
 
-    return byte != 0;
+    while (myBufferSize <= BUFFER_LENGTH - byteLength &&
+           myNextByte < myBytes.size())
+    {
+        const int shift = BUFFER_LENGTH - byteLength - myBufferSize;
+        myBuffer |= static_cast<uint64_t>(myBytes[myNextByte++]) << shift;
+        myBufferSize += byteLength;
+    }
 }
 
 int32_t Gpx::BitStream::readBits(int n, BitOrder order)
 {
-    int32_t value = 0;
+    assert(n >= 0 && n <= 32);
+    if (n == 0)
+        return 0;
+
+    if (myBufferSize < n)
+        refill();
+
+    // If we've run out of input, the missing bits are zero.
+    uint32_t value = static_cast<uint32_t>(myBuffer >> (BUFFER_LENGTH - n));
+    myBuffer <<= n;
+    myBufferSize = std::max(myBufferSize - n, 0);
+    myPosition += n;
 
     if (order == Reversed)
     {
-        for (int i = 0; i < n; ++i)
-            value |= (readBit() << i);
-    }
-    else
-    {
-        for (int i = n - 1; i >= 0; --i)
-            value |= (readBit() << i);
+        uint32_t reversed = 0;
+        for (int i = 0; i < n; ++i, value >>= 1)
+            reversed = (reversed << 1) | (value & 1);
+
+        value = reversed;
     }
 
-    return value;
+    return static_cast<int32_t>(value);
 }
 
 size_t Gpx::BitStream::getLocation() const
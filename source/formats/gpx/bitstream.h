@@ -27,6 +27,8 @@ namespace Gpx
 
 /// Provides the ability to read individual bits from a stream.
 /// This is required for the compression scheme used in .gpx files.
+/// Bits are read from a 64-bit buffer, which is refilled a byte at a time, so
+/// that several bits can be extracted at once.
 class BitStream
 {
 public:
@@ -45,7 +47,8 @@ public:
     /// Reads the next bit from the stream.
     bool readBit();
 
-    /// Reads the next n bits from the stream into an integer.
+    /// Reads the next n bits (at most 32) from the stream into an integer.
+    /// Any bits past the end of the stream are zero.
     int32_t readBits(int n, BitOrder = Normal);
 
     /// Returns the position in the stream (measured in bytes).
@@ -55,10 +58,20 @@ public:
     bool isAtEnd() const;
 
 private:
+    /// Loads bytes into the buffer until it is full or there is no input left.
+    void refill();
+
     /// The current position in the input (measured in bits).
     size_t myPosition;
     /// The compressed data being read.
     std::vector<uint8_t> myBytes;
+    /// The index of the next byte to load into the buffer.
+    size_t myNextByte;
+    /// Bits that have been loaded but not read yet, starting from the most
+    /// significant bit.
+    uint64_t myBuffer;
+    /// The number of valid bits in the buffer.
+    int myBufferSize;
 };
 
 }
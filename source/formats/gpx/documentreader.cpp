@@ -25,6 +25,9 @@
 #include <stdexcept>
 
 static const int POSITIONS_PER_SYSTEM = 35;
+/// The number of unused ids to allow when reading items, which prevents a
+/// corrupt id from allocating a huge table.
+static const int MAX_UNUSED_IDS = 1 << 16;
 
 using namespace pugi;
 
@@ -45,9 +48,39 @@ static void convertStringToList(const std::string &source, std::vector<T> &dest)
         std::cerr << "Parsing of list failed!!" << std::endl;
 }
 
-Gpx::DocumentReader::DocumentReader(const std::string &xml)
+/// Stores an item in a table indexed by its id. Guitar Pro numbers the items
+/// in each section consecutively, so the table is dense.
+template <typename T>
+static void insertById(std::vector<T> &items, const T &item)
 {
-    xml_parse_result result = myXmlData.load(xml.c_str());
+    const int size = static_cast<int>(items.size());
+    if (item.id < 0 || item.id >= size + MAX_UNUSED_IDS)
+        throw std::runtime_error("Invalid id");
+
+    if (item.id >= size)
+    {
+        T unused = T();
+        unused.id = -1;
+        items.resize(item.id + 1, unused);
+    }
+
+    items[item.id] = item;
+}
+
+/// Returns the item with the given id, or throws if there isn't one.
+template <typename T>
+static const T &findById(const std::vector<T> &items, int id)
+{
+    if (id < 0 || id >= static_cast<int>(items.size()) || items[id].id != id)
+        throw std::runtime_error("Invalid reference to id " +
+                                 std::to_string(id));
+
+    return items[id];
+}
+
+Gpx::DocumentReader::DocumentReader(char *xml, size_t length)
+{
+    xml_parse_result result = myXmlData.load_buffer_inplace(xml, length);
 
     if (result.status != pugi::status_ok)
         throw std::runtime_error(result.description());
@@ -151,7 +184,7 @@ void Gpx::DocumentReader::readBars()
         bar.id = currentBar.attribute("id").as_int();
         convertStringToList(currentBar.child_value("Voices"), bar.voiceIds);
 
-        myBars[bar.id] = bar;
+        insertById(myBars, bar);
     }
 }
 
@@ -163,7 +196,7 @@ void Gpx::DocumentReader::readVoices()
         voice.id = currentVoice.attribute("id").as_int();
         convertStringToList(currentVoice.child_value("Beats"), voice.beatIds);
 
-        myVoices[voice.id] = voice;
+        insertById(myVoices, voice);
     }
 }
 
@@ -193,7 +226,7 @@ void Gpx::DocumentReader::readBeats()
             }
         }
 
-        myBeats[beat.id] = beat;
+        insertById(myBeats, beat);
     }
 }
 
@@ -207,7 +240,7 @@ void Gpx::DocumentReader::readRhythms()
         // Convert duration to PowerTab format.
         const std::string noteValueStr = currentRhythm.child_value("NoteValue");
 
-        std::map<std::string, int> noteValuesToInt = {
+        static const std::map<std::string, int> noteValuesToInt = {
 			{ "Whole", 1 }, { "Half", 2 }, { "Quarter", 4 },
 			{ "Eighth", 8 }, { "16th", 16 }, { "32nd", 32 },
 			{ "64th", 64 }
@@ -223,7 +256,7 @@ void Gpx::DocumentReader::readRhythms()
         rhythm.dotted = numDots == 1;
         rhythm.doubleDotted = numDots == 2;
 
-        myRhythms[rhythm.id] = rhythm;
+        insertById(myRhythms, rhythm);
     }
 }
 
@@ -244,7 +277,7 @@ void Gpx::DocumentReader::readNotes()
         note.letRing = !currentNote.child("LetRing").empty();
         note.trillNote = currentNote.child("Trill").text().as_int(-1);
 
-        myNotes[note.id] = note;
+        insertById(myNotes, note);
     }
 }
 
@@ -306,9 +339,10 @@ void Gpx::DocumentReader::readMasterBars(Score &score)
 
         Barline barline;
 
-        if (myAutomations.find(barIndex) != myAutomations.end())
+        auto automationIt = myAutomations.find(barIndex);
+        if (automationIt != myAutomations.end())
         {
-            const Automation automation = myAutomations.find(barIndex)->second;
+            const Automation &automation = automationIt->second;
             if (automation.type == "Tempo")
             {
                 if (automation.value.size() != 2)
@@ -344,10 +378,17 @@ void Gpx::DocumentReader::readMasterBars(Score &score)
             int currentPos = (startPos != 0) ? startPos + 1 : 0;
 
             // TODO - import multiple voices.
-            for (int beatId :
-                 myVoices[myBars[barIds[i]].voiceIds.at(0)].beatIds)
+            const Gpx::Bar &bar = findById(myBars, barIds[i]);
+            const int voiceId = bar.voiceIds.at(0);
+
+            // An empty voice has an id of -1.
+            static const std::vector<int> noBeats;
+            const std::vector<int> &beatIds =
+                (voiceId < 0) ? noBeats : findById(myVoices, voiceId).beatIds;
+
+            for (int beatId : beatIds)
             {
-                const Gpx::Beat &beat = myBeats[beatId];
+                const Gpx::Beat &beat = findById(myBeats, beatId);
 
                 // Create text item at this position if necessary.
                 if (!beat.freeText.empty())
@@ -366,7 +407,7 @@ void Gpx::DocumentReader::readMasterBars(Score &score)
                 pos.setProperty(Position::TremoloPicking, beat.tremoloPicking);
                 pos.setProperty(Position::Acciaccatura, beat.graceNote);
 
-                const Gpx::Rhythm &rhythm = myRhythms.at(beat.rhythmId);
+                const Gpx::Rhythm &rhythm = findById(myRhythms, beat.rhythmId);
                 pos.setDurationType(static_cast<Position::DurationType>(
                                         rhythm.noteValue));
                 pos.setProperty(Position::Dotted, rhythm.dotted);
@@ -475,7 +516,7 @@ void Gpx::DocumentReader::readTimeSignature(const xml_node &masterBar,
 Note Gpx::DocumentReader::convertNote(int noteId, Position &position,
                                       const Tuning &tuning) const
 {
-    Gpx::TabNote gpxNote = myNotes.at(noteId);
+    const Gpx::TabNote &gpxNote = findById(myNotes, noteId);
     Note ptbNote;
 
     ptbNote.setProperty(Note::Tied, gpxNote.tied);
@@ -90,7 +90,9 @@ struct Automation
 class DocumentReader
 {
 public:
-    DocumentReader(const std::string &xml);
+    /// Parses the XML data in place, without copying it. The buffer is
+    /// modified and must outlive the reader.
+    DocumentReader(char *xml, size_t length);
 
     void readScore(Score &score);
 
@@ -117,11 +119,13 @@ private:
     pugi::xml_document myXmlData;
     pugi::xml_node myFile;
 
-    std::map<int, Gpx::Bar> myBars;
-    std::map<int, Gpx::Voice> myVoices;
-    std::map<int, Gpx::Beat> myBeats;
-    std::map<int, Gpx::Rhythm> myRhythms;
-    std::map<int, Gpx::TabNote> myNotes;
+    /// These are indexed by id. Unused ids have an id of -1.
+    std::vector<Gpx::Bar> myBars;
+    std::vector<Gpx::Voice> myVoices;
+    std::vector<Gpx::Beat> myBeats;
+    std::vector<Gpx::Rhythm> myRhythms;
+    std::vector<Gpx::TabNote> myNotes;
+    /// Maps bar numbers to automations.
     std::map<int, Gpx::Automation> myAutomations;
 };
 }
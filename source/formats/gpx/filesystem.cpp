@@ -17,6 +17,7 @@
   
 #include "filesystem.h"
 
+#include <algorithm>
 #include "bitstream.h"
 #include <boost/algorithm/clamp.hpp>
 #include <cassert>
@@ -46,8 +47,16 @@ Gpx::FileSystem::FileSystem(std::istream &stream)
         throw FileFormatException("Invalid header");
 
     const uint32_t length = input.readInt();
-    std::vector<uint8_t> output;
-    output.reserve(length);
+
+    // Write directly into a buffer of the expected size rather than appending
+    // one byte at a time. The buffer only needs to grow if the data is longer
+    // than the header claimed.
+    std::vector<uint8_t> output(length);
+    size_t outputSize = 0;
+    auto reserve = [&](size_t n) {
+        if (outputSize + n > output.size())
+            output.resize(std::max(output.size() * 2, outputSize + n));
+    };
 
     // We now have a succession of compressed and uncompressed chunks.
     while (!input.isAtEnd() && input.getLocation() < length)
@@ -60,8 +69,9 @@ Gpx::FileSystem::FileSystem(std::istream &stream)
         {
             const int32_t rawLength = input.readBits(2, Gpx::BitStream::Reversed);
 
+            reserve(rawLength);
             for (int32_t i = 0; i < rawLength; ++i)
-                output.push_back(input.readBits(8));
+                output[outputSize++] = input.readBits(8);
         }
         // For a compressed chunk, we have a 4-bit integer giving a length P,
         // then two integers of P bits representing the offset and length of the
@@ -71,30 +81,40 @@ Gpx::FileSystem::FileSystem(std::istream &stream)
         {
             const int32_t p = input.readBits(4);
             const int32_t offset = input.readBits(p, Gpx::BitStream::Reversed);
-            const size_t startPos = output.size() - offset;
+            if (static_cast<size_t>(offset) > outputSize)
+                throw FileFormatException("Invalid GPX Format");
+
+            const size_t startPos = outputSize - offset;
 
+            // Since the length is at most the offset, the source and
+            // destination ranges never overlap.
             const int32_t length = boost::algorithm::clamp<int32_t>(
                 input.readBits(p, Gpx::BitStream::Reversed), 0, offset);
 
+            reserve(length);
             std::copy(output.begin() + startPos,
                       output.begin() + startPos + length,
-                      std::back_inserter(output));
+                      output.begin() + outputSize);
+            outputSize += length;
         }
     }
 
+    output.resize(outputSize);
+
     // The data we just read should now have a header indicating that it's
     // uncompressed!
     const uint32_t newHeader = Gpx::Util::readUInt(output, 0);
     if (newHeader != BCFS_HEADER)
         throw FileFormatException("Invalid GPX Format");
 
-    readUncompressedData(output);
+    myData.swap(output);
+    readUncompressedData();
 }
 
-const std::string &Gpx::FileSystem::getFileContents(
+const Gpx::FileSystem::File &Gpx::FileSystem::findFile(
         const std::string &filename) const
 {
-    std::map<std::string, std::string>::const_iterator file = myFiles.find(filename);
+    auto file = myFiles.find(filename);
 
     if (file == myFiles.end())
         throw FileFormatException("Invalid filename");
@@ -102,50 +122,95 @@ const std::string &Gpx::FileSystem::getFileContents(
         return file->second;
 }
 
-void Gpx::FileSystem::readUncompressedData(std::vector<uint8_t> &data)
+boost::string_ref Gpx::FileSystem::getFileContents(
+        const std::string &filename) const
+{
+    const File &file = findFile(filename);
+    return boost::string_ref(
+        reinterpret_cast<const char *>(myData.data()) + file.offset, file.size);
+}
+
+boost::iterator_range<char *> Gpx::FileSystem::getFileData(
+        const std::string &filename)
 {
-    // Remove the BCFS header.
-    data.erase(data.begin(), data.begin() + 4);
+    const File &file = findFile(filename);
+    char *data = reinterpret_cast<char *>(myData.data()) + file.offset;
+    return boost::make_iterator_range(data, data + file.size);
+}
+
+void Gpx::FileSystem::readUncompressedData()
+{
+    // Skip the BCFS header.
+    const size_t start = 4;
+    const size_t dataSize = myData.size() - start;
     size_t offset = 0;
 
     // Read all files from the file system.
-    while ( (offset = (offset + SECTOR_SIZE)) + 3 < data.size())
+    while ( (offset = (offset + SECTOR_SIZE)) + 3 < dataSize)
     {
-        if (Util::readUInt(data, offset) == 2)
+        if (Util::readUInt(myData, start + offset) == 2)
         {
-            const size_t fileNameIndex = offset + 4;
-            const size_t fileSizeIndex= offset + 0x8C;
-            const size_t blockIndex= offset + 0x94;
+            const size_t fileNameIndex = start + offset + 4;
+            const size_t fileSizeIndex = start + offset + 0x8C;
+            const size_t blockIndex = start + offset + 0x94;
 
             int block = 0;
             int blockCount = 0;
-            std::vector<uint8_t> fileData;
+            std::vector<std::pair<size_t, size_t>> blocks;
 
-            // Read the file data.
-            while ((block = Util::readUInt(data,
+            // Find the sectors containing the file data.
+            while ((block = Util::readUInt(myData,
                                            blockIndex + 4 * blockCount)) != 0)
             {
                 offset = block * SECTOR_SIZE;
-                std::copy(data.begin() + offset,
-                          data.begin() +
-                          boost::algorithm::clamp<size_t>(offset + SECTOR_SIZE,
-                                                          0, data.size()),
-                          std::back_inserter(fileData));
+                blocks.push_back(std::make_pair(
+                    start + std::min<size_t>(offset, dataSize),
+                    start + std::min<size_t>(offset + SECTOR_SIZE, dataSize)));
                 ++blockCount;
             }
 
+            size_t availableSize = 0;
+            bool contiguous = true;
+            for (size_t i = 0; i < blocks.size(); ++i)
+            {
+                availableSize += blocks[i].second - blocks[i].first;
+                if (i > 0 && blocks[i].first != blocks[i - 1].second)
+                    contiguous = false;
+            }
+
             // Read the file name and save the file.
-            const uint32_t fileSize = Util::readUInt(data, fileSizeIndex);
-            if (fileData.size() >= fileSize)
+            const uint32_t fileSize = Util::readUInt(myData, fileSizeIndex);
+            if (availableSize >= fileSize)
             {
-                std::string fileName;
-                std::copy(data.begin() + fileNameIndex,
-                          data.begin() + fileNameIndex + 127,
-                          std::back_inserter(fileName));
+                std::string fileName(
+                    reinterpret_cast<const char *>(&myData[fileNameIndex]),
+                    127);
                 // Trim extra NULL characters.
                 fileName.erase(fileName.find_last_not_of('\0') + 1);
 
-                std::string file(fileData.begin(), fileData.begin() + fileSize);
+                File file;
+                file.size = fileSize;
+
+                // The file can usually be referenced in place, but if its
+                // sectors are scattered they need to be joined together at the
+                // end of the data.
+                if (contiguous && !blocks.empty())
+                    file.offset = blocks.front().first;
+                else
+                {
+                    file.offset = myData.size();
+                    myData.resize(file.offset + availableSize);
+
+                    size_t dest = file.offset;
+                    for (const auto &range : blocks)
+                    {
+                        std::copy(myData.begin() + range.first,
+                                  myData.begin() + range.second,
+                                  myData.begin() + dest);
+                        dest += range.second - range.first;
+                    }
+                }
+
                 myFiles[fileName] = file;
             }
         }
@@ -18,6 +18,8 @@
 #ifndef FORMATS_GPX_FILESYSTEM_H
 #define FORMATS_GPX_FILESYSTEM_H
 
+#include <boost/range/iterator_range_core.hpp>
+#include <boost/utility/string_ref.hpp>
 #include <cstdint>
 #include <iosfwd>
 #include <map>
@@ -35,13 +37,29 @@ class FileSystem
 public:
     FileSystem(std::istream &stream);
 
-    const std::string &getFileContents(const std::string &filename) const;
+    /// Returns the contents of a file. The data is owned by the filesystem, so
+    /// no copies are made.
+    boost::string_ref getFileContents(const std::string &filename) const;
+
+    /// Returns the contents of a file, which may be modified in place (e.g. by
+    /// an XML parser). The data is owned by the filesystem.
+    boost::iterator_range<char *> getFileData(const std::string &filename);
 
 private:
-    void readUncompressedData(std::vector<uint8_t> &data);
+    /// The location of a file's contents in the decompressed data.
+    struct File
+    {
+        size_t offset;
+        size_t size;
+    };
+
+    const File &findFile(const std::string &filename) const;
+    void readUncompressedData();
 
+    /// The decompressed filesystem, which contains the contents of each file.
+    std::vector<uint8_t> myData;
     /// Maps filenames to file contents.
-    std::map<std::string, std::string> myFiles;
+    std::map<std::string, File> myFiles;
 };
 
 }
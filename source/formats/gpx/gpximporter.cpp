@@ -34,7 +34,8 @@ void GpxImporter::load(const std::string &filename, Score &score)
     std::ifstream file(filename.c_str(), std::ios::binary | std::ios::in);
     Gpx::FileSystem fs(file);
 
-    Gpx::DocumentReader reader(fs.getFileContents("score.gpif"));
+    auto contents = fs.getFileData("score.gpif");
+    Gpx::DocumentReader reader(contents.begin(), contents.size());
     reader.readScore(score);
 
     ScoreUtils::polishScore(score);
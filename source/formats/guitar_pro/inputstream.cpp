@@ -31,10 +31,19 @@ const std::map<std::string, Gp::Version> theVersionStrings = {
     { "FICHIER GUITAR PRO v5.10", Gp::Version5_1 }
 };
 
-Gp::InputStream::InputStream(std::istream &stream) : myStream(stream)
+Gp::InputStream::InputStream(std::istream &stream) : myPosition(0)
 {
-    myStream.exceptions(std::istream::failbit | std::istream::badbit |
-                       std::istream::eofbit);
+    // Read the whole file at once, rather than making a separate read call
+    // for every value.
+    stream.seekg(0, std::ios::end);
+    const std::streamoff size = stream.tellg();
+    if (!stream || size < 0)
+        throw FileFormatException("Could not read file");
+
+    myData.resize(static_cast<size_t>(size));
+    stream.seekg(0, std::ios::beg);
+    if (!myData.empty() && !stream.read(myData.data(), myData.size()))
+        throw FileFormatException("Could not read file");
 
     const std::string versionString = readVersionString();
 
@@ -47,14 +56,14 @@ Gp::InputStream::InputStream(std::istream &stream) : myStream(stream)
 
 std::string Gp::InputStream::readVersionString()
 {
-    myStream.seekg(std::ios_base::beg);
+    myPosition = 0;
 
     // THe version consists of a 30 character string, although not all 30
     // characters may be used.
     std::string version = readCharacterString<uint8_t>();
 
     // Skip past any unread characters to land at position 0x1f.
-    myStream.seekg(31, std::ios_base::beg);
+    myPosition = 31;
 
     return version;
 }
@@ -78,15 +87,8 @@ std::string Gp::InputStream::readFixedLengthString(uint32_t maxLength)
 {
     const uint8_t actualLength = read<uint8_t>();
 
-    std::string str;
-
-    if (maxLength != 0)
-        str.resize(maxLength);
-    else
-        str.resize(actualLength);
-
-    if (str.size() != 0)
-        myStream.read(&str[0], str.size());
+    const size_t length = (maxLength != 0) ? maxLength : actualLength;
+    std::string str(readBytes(length), length);
 
     str.resize(actualLength);
     return str;
@@ -94,5 +96,15 @@ std::string Gp::InputStream::readFixedLengthString(uint32_t maxLength)
 
 void Gp::InputStream::skip(int numBytes)
 {
-    myStream.seekg(numBytes, std::ios_base::cur);
+    // As with seeking in a file, it's fine to skip past the end as long as
+    // nothing else is read.
+    if (numBytes < 0 && static_cast<size_t>(-numBytes) > myPosition)
+        throw FileFormatException("Invalid seek");
+
+    myPosition += numBytes;
+}
+
+void Gp::InputStream::throwUnexpectedEnd() const
+{
+    throw FileFormatException("Unexpected end of file");
 }
\ No newline at end of file
@@ -20,7 +20,9 @@
 
 #include <bitset>
 #include <cstdint>
+#include <cstring>
 #include <istream>
+#include <string>
 #include <vector>
 
 #include "document.h"
@@ -30,6 +32,9 @@ namespace Gp
 
 typedef std::bitset<8> Flags;
 
+/// Reads data from a Guitar Pro file. The entire file is read into memory up
+/// front, and a FileFormatException is thrown if any read goes past the end
+/// of the file.
 class InputStream
 {
 public:
@@ -70,7 +75,24 @@ private:
     template <class LengthPrefixType>
     std::string readCharacterString();
 
-    std::istream &myStream;
+    /// Returns a pointer to the next n bytes and advances past them, or throws
+    /// if the end of the file is reached.
+    const char *readBytes(size_t n)
+    {
+        if (myPosition + n > myData.size())
+            throwUnexpectedEnd();
+
+        const char *data = myData.data() + myPosition;
+        myPosition += n;
+        return data;
+    }
+
+    void throwUnexpectedEnd() const;
+
+    std::vector<char> myData;
+    /// The current offset into the data, which may be past the end after a
+    /// skip().
+    size_t myPosition;
 };
 
 template <class T>
@@ -78,7 +100,7 @@ inline T InputStream::read()
 {
     static_assert(std::is_arithmetic<T>::value, "T must be an arithmetic type");
     T data;
-    myStream.read((char *)&data, sizeof(data));
+    std::memcpy(&data, readBytes(sizeof(data)), sizeof(data));
     return data;
 }
 
@@ -90,13 +112,7 @@ inline std::string InputStream::readCharacterString()
 
     const LengthPrefixType length = read<LengthPrefixType>();
 
-    std::string str;
-    str.resize(length);
-
-    if (length != 0)
-        myStream.read(&str[0], length);
-
-    return str;
+    return std::string(readBytes(length), length);
 }
 }
 
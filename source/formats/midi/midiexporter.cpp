@@ -18,8 +18,8 @@
 #include "midiexporter.h"
 
 #include <app/settingsmanager.h>
-#include <audio/settings.h>
 #include <midi/midifile.h>
+#include <midi/settings.h>
 #include <score/generalmidi.h>
 
 #include <array>
@@ -140,7 +140,7 @@ void MidiExporter::writeTrack(std::ostream & os, const MidiEventList & events)
     for (const MidiEvent &event : events)
     {
         writeVariableLength(os, event.getTicks());
-        os.write(reinterpret_cast<const char *>(event.getData().data()),
+        os.write(reinterpret_cast<const char *>(event.getData().begin()),
                  event.getData().size());
     }
 
@@ -18,14 +18,18 @@
 #include "powertabexporter.h"
 
 #include "common.h"
+#include <app/settingsmanager.h>
 #include <boost/iostreams/filtering_streambuf.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
+#include <formats/settings.h>
 #include <fstream>
+#include <score/binaryserialization.h>
 #include <score/score.h>
 #include <score/serialization.h>
 
-PowerTabExporter::PowerTabExporter()
-    : FileFormatExporter(getPowerTabFileFormat())
+PowerTabExporter::PowerTabExporter(const SettingsManager &settings_manager)
+    : FileFormatExporter(getPowerTabFileFormat()),
+      mySettingsManager(settings_manager)
 {
 }
 
@@ -37,6 +41,15 @@ void PowerTabExporter::save(const std::string &filename, const Score &score)
     out.push(boost::iostreams::gzip_compressor());
     out.push(file);
 
+    bool binary = false;
+    {
+        auto settings = mySettingsManager.getReadHandle();
+        binary = settings->get(Settings::SaveBinaryDocuments);
+    }
+
     std::ostream compressed_output(&out);
-    ScoreUtils::save(compressed_output, "score", score);
+    if (binary)
+        ScoreUtils::saveBinary(compressed_output, "score", score);
+    else
+        ScoreUtils::save(compressed_output, "score", score);
 }
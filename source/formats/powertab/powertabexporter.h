@@ -20,12 +20,17 @@
 
 #include <formats/fileformatmanager.h>
 
+class SettingsManager;
+
 class PowerTabExporter : public FileFormatExporter
 {
 public:
-    PowerTabExporter();
+    PowerTabExporter(const SettingsManager &settings_manager);
 
     virtual void save(const std::string &filename, const Score &score) override;
+
+private:
+    const SettingsManager &mySettingsManager;
 };
 
 #endif
@@ -21,6 +21,7 @@
 #include <boost/iostreams/filtering_streambuf.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
 #include <fstream>
+#include <score/binaryserialization.h>
 #include <score/score.h>
 #include <score/serialization.h>
 
@@ -39,5 +40,8 @@ void PowerTabImporter::load(const std::string &filename, Score &score)
     in.push(file);
 
     std::istream compressed_input(&in);
-    ScoreUtils::load(compressed_input, "score", score);
+    if (ScoreUtils::isBinaryArchive(compressed_input))
+        ScoreUtils::loadBinary(compressed_input, "score", score);
+    else
+        ScoreUtils::load(compressed_input, "score", score);
 }
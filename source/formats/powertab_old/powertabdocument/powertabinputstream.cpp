@@ -19,10 +19,20 @@ namespace PowerTabDocument {
 using std::string;
 
 PowerTabInputStream::PowerTabInputStream(std::istream& stream) :
-    m_stream(stream)
+    m_position(0), m_classTable(1, false)
 {
     // ensure that the stream will throw std::ifstream::failure if any errors occur
     stream.exceptions(std::istream::failbit | std::istream::badbit | std::istream::eofbit);
+
+    // read the whole stream at once rather than making a call for every value
+    stream.seekg(0, std::ios_base::end);
+    m_data.resize(static_cast<size_t>(stream.tellg()));
+    stream.seekg(0, std::ios_base::beg);
+
+    if (!m_data.empty())
+    {
+        stream.read(&m_data[0], m_data.size());
+    }
 }
 
 // Read Functions
@@ -51,15 +61,8 @@ uint32_t PowerTabInputStream::ReadCount()
 /// @return True if the string was read, false if not
 void PowerTabInputStream::ReadMFCString(string& str)
 {
-    str.clear();
-
     const uint32_t length = ReadMFCStringLength();
-    str.resize(length);
-
-	if (length != 0)
-	{
-		m_stream.read(&str[0], length);
-	}
+    str.assign(ReadBytes(length), length);
 }
 
 /// Reads a Win32 format COLORREF type from the stream
@@ -129,11 +132,22 @@ void PowerTabInputStream::ReadClassInformation()
 
         *this >> schema;
         *this >> length;
-        m_stream.seekg(length, std::ios_base::cur);
-    }
+        ReadBytes(length);
 
+        m_classTable.push_back(true);
+    }
     // otherwise, existing class index in obj_tag followed by new object
-    // no more reading to do here
+    else
+    {
+        const uint32_t classIndex = obj_tag & ~BIG_CLASS_TAG;
+        if (classIndex >= m_classTable.size() || !m_classTable[classIndex])
+        {
+            throw std::ios_base::failure("Invalid class index");
+        }
+    }
+
+    // the new object also takes up an index in the map
+    m_classTable.push_back(false);
 }
 
 
@@ -163,4 +177,9 @@ uint32_t PowerTabInputStream::ReadMFCStringLength()
     return doubleWordLength;
 }
 
+void PowerTabInputStream::ThrowEndOfData() const
+{
+    throw std::ios_base::failure("Unexpected end of data");
+}
+
 }
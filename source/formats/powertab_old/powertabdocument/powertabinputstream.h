@@ -14,8 +14,10 @@
 
 #include <array>
 #include <cstdint>
+#include <cstring>
 #include <istream>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace PowerTabDocument {
@@ -24,11 +26,17 @@ class Rect;
 class Colour;
 
 /// Input stream used to deserialize MFC based Power Tab data
+/// The entire stream is read into memory up front, and std::ios_base::failure
+/// is thrown if any read goes past the end of the data
 class PowerTabInputStream
 {
     // Member Variables
 private:
-    std::istream& m_stream;
+    std::vector<char> m_data;                   ///< Contents of the stream
+    size_t m_position;                          ///< Current offset into the data
+    /// Whether each entry in the archive's map of classes and objects is a
+    /// class, indexed by the MFC map index (0 is reserved for NULL)
+    std::vector<bool> m_classTable;
 
 public:
     PowerTabInputStream(std::istream& stream);
@@ -43,6 +51,22 @@ private:
     void ReadClassInformation();
     uint32_t ReadMFCStringLength();
 
+    /// Returns a pointer to the next count bytes and advances past them
+    /// @throw std::ios_base::failure if the end of the data is reached
+    const char* ReadBytes(size_t count)
+    {
+        if (m_position + count > m_data.size())
+        {
+            ThrowEndOfData();
+        }
+
+        const char* data = m_data.data() + m_position;
+        m_position += count;
+        return data;
+    }
+
+    void ThrowEndOfData() const;
+
 public:
 
     template <class T>
@@ -65,7 +89,7 @@ public:
     template<class T>
     inline PowerTabInputStream& operator>>(T& data)
     {
-        m_stream.read(reinterpret_cast<char *>(&data), sizeof(data));
+        std::memcpy(&data, ReadBytes(sizeof(data)), sizeof(data));
         return *this;
     }
 
@@ -78,7 +102,11 @@ public:
         vect.clear();
         vect.resize(size);
 
-        m_stream.read((char*)&vect[0], size * sizeof(T));
+        if (size != 0)
+        {
+            std::memcpy(&vect[0], ReadBytes(size * sizeof(T)),
+                        size * sizeof(T));
+        }
     }
 
     template <class T, size_t N>
@@ -87,7 +115,16 @@ public:
         uint8_t size = 0;
         *this >> size;
 
-        m_stream.read((char*)&array[0], size * sizeof(T));
+        if (size > N)
+        {
+            throw std::ios_base::failure("Invalid array size");
+        }
+
+        if (size != 0)
+        {
+            std::memcpy(&array[0], ReadBytes(size * sizeof(T)),
+                        size * sizeof(T));
+        }
     }
 
 private:
@@ -881,6 +881,8 @@ void PowerTabOldImporter::convertGuitarIns(
         score.getSystems()[i].insertPlayerChange(
             getPlayerChange(activePlayers, static_cast<int>(currentPosition)));
     }
+
+    score.updateIndexes(0);
 }
 
 void PowerTabOldImporter::convertInitialVolumes(
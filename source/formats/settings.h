@@ -0,0 +1,31 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FORMATS_SETTINGS_H
+#define FORMATS_SETTINGS_H
+
+#include <util/settingstree.h>
+
+/// File format settings and their default values.
+namespace Settings
+{
+    /// Save .pt2 files with the binary archive instead of JSON. Binary files
+    /// load faster, but cannot be opened by older releases.
+    extern const Setting<bool> SaveBinaryDocuments;
+}
+
+#endif
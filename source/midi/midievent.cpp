@@ -17,6 +17,7 @@
   
 #include "midievent.h"
 
+#include <algorithm>
 #include <cassert>
 
 enum Controller : uint8_t
@@ -41,33 +42,33 @@ static const uint8_t theSysExManufacturerId = 0x7d;
 static const uint8_t theChannelMask = 0x0f;
 static const uint8_t theStatusByteMask = ~theChannelMask;
 
-MidiEvent::MidiEvent(int ticks, std::vector<uint8_t> data,
-                     const SystemLocation &location, int player, int instrument)
+MidiEvent::MidiEvent(int ticks, std::initializer_list<uint8_t> data,
+                     const SystemLocation &location)
     : myTicks(ticks),
-      myData(std::move(data)),
       myLocation(location),
-      myPlayer(player),
-      myInstrument(instrument)
+      mySize(static_cast<uint8_t>(data.size()))
 {
+    assert(data.size() > 0 && data.size() <= myData.size());
+    std::copy(data.begin(), data.end(), myData.begin());
 }
 
 MidiEvent MidiEvent::endOfTrack(int ticks)
 {
     return MidiEvent(ticks, { StatusByte::MetaMessage, MetaType::TrackEnd, 0 },
-                     SystemLocation(), -1, -1);
+                     SystemLocation());
 }
 
 bool MidiEvent::isTempoChange() const
 {
     return getStatusByte() == StatusByte::MetaMessage &&
-           myData[1] == MetaType::SetTempo;
+           getDataPtr()[1] == MetaType::SetTempo;
 }
 
 int MidiEvent::getTempo() const
 {
     assert(isTempoChange());
-    assert(myData[2] == 3);
-    return myData[5] + (myData[4] << 8) + (myData[3] << 16);
+    assert(getDataPtr()[2] == 3);
+    return getDataPtr()[5] + (getDataPtr()[4] << 8) + (getDataPtr()[3] << 16);
 }
 
 bool MidiEvent::isProgramChange() const
@@ -83,7 +84,7 @@ MidiEvent MidiEvent::setTempo(int ticks, int microseconds)
                               static_cast<uint8_t>((val >> 16) & 0xff),
                               static_cast<uint8_t>((val >> 8) & 0xff),
                               static_cast<uint8_t>(val & 0xff) },
-                     SystemLocation(), -1, -1);
+                     SystemLocation());
 }
 
 MidiEvent MidiEvent::noteOn(int ticks, uint8_t channel, uint8_t pitch,
@@ -92,7 +93,7 @@ MidiEvent MidiEvent::noteOn(int ticks, uint8_t channel, uint8_t pitch,
     return MidiEvent(
         ticks,
         { static_cast<uint8_t>(StatusByte::NoteOn + channel), pitch, velocity },
-        location, -1, -1);
+        location);
 }
 
 MidiEvent MidiEvent::noteOff(int ticks, uint8_t channel, uint8_t pitch,
@@ -101,7 +102,7 @@ MidiEvent MidiEvent::noteOff(int ticks, uint8_t channel, uint8_t pitch,
     return MidiEvent(
         ticks,
         { static_cast<uint8_t>(StatusByte::NoteOff + channel), pitch, 127 },
-        location, -1, -1);
+        location);
 }
 
 MidiEvent MidiEvent::volumeChange(int ticks, uint8_t channel, uint8_t level)
@@ -109,7 +110,7 @@ MidiEvent MidiEvent::volumeChange(int ticks, uint8_t channel, uint8_t level)
     return MidiEvent(
         ticks, { static_cast<uint8_t>(StatusByte::ControlChange + channel),
                  Controller::ChannelVolume, level },
-        SystemLocation(), -1, -1);
+        SystemLocation());
 }
 
 MidiEvent MidiEvent::programChange(int ticks, uint8_t channel, uint8_t preset)
@@ -117,7 +118,7 @@ MidiEvent MidiEvent::programChange(int ticks, uint8_t channel, uint8_t preset)
     return MidiEvent(
         ticks,
         { static_cast<uint8_t>(StatusByte::ProgramChange + channel), preset },
-        SystemLocation(), -1, -1);
+        SystemLocation());
 }
 
 MidiEvent MidiEvent::modWheel(int ticks, uint8_t channel, uint8_t width)
@@ -125,7 +126,7 @@ MidiEvent MidiEvent::modWheel(int ticks, uint8_t channel, uint8_t width)
     return MidiEvent(
         ticks, { static_cast<uint8_t>(StatusByte::ControlChange + channel),
                  Controller::ModWheel, width },
-        SystemLocation(), -1, -1);
+        SystemLocation());
 }
 
 MidiEvent MidiEvent::holdPedal(int ticks, uint8_t channel, bool enabled)
@@ -134,7 +135,7 @@ MidiEvent MidiEvent::holdPedal(int ticks, uint8_t channel, bool enabled)
         ticks,
         { static_cast<uint8_t>(StatusByte::ControlChange + channel),
           Controller::HoldPedal, static_cast<uint8_t>(enabled ? 127 : 0) },
-        SystemLocation(), -1, -1);
+        SystemLocation());
 }
 
 MidiEvent MidiEvent::pitchWheel(int ticks, uint8_t channel, uint8_t amount)
@@ -142,20 +143,20 @@ MidiEvent MidiEvent::pitchWheel(int ticks, uint8_t channel, uint8_t amount)
     return MidiEvent(
         ticks,
         { static_cast<uint8_t>(StatusByte::PitchWheel + channel), 0, amount },
-        SystemLocation(), -1, -1);
+        SystemLocation());
 }
 
 MidiEvent MidiEvent::positionChange(int ticks, const SystemLocation &location)
 {
     return MidiEvent(
         ticks, { StatusByte::SysEx, theSysExManufacturerId, theSysExMsgEnd },
-        location, -1, -1);
+        location);
 }
 
 bool MidiEvent::isPositionChange() const
 {
     return getStatusByte() == StatusByte::SysEx &&
-           myData[1] == theSysExManufacturerId;
+           getDataPtr()[1] == theSysExManufacturerId;
 }
 
 bool MidiEvent::isNoteOnOff() const
@@ -176,18 +177,18 @@ std::vector<MidiEvent> MidiEvent::pitchWheelRange(int ticks, uint8_t channel,
         MidiEvent(ticks,
                   { static_cast<uint8_t>(StatusByte::ControlChange + channel),
                     Controller::RpnMsb, 0 },
-                  SystemLocation(), -1, -1),
+                  SystemLocation()),
         MidiEvent(ticks,
                   { static_cast<uint8_t>(StatusByte::ControlChange + channel),
                     Controller::RpnLsb, 0 },
-                  SystemLocation(), -1, -1),
+                  SystemLocation()),
         MidiEvent(ticks,
                   { static_cast<uint8_t>(StatusByte::ControlChange + channel),
                     Controller::DataEntryCoarse, semitones },
-                  SystemLocation(), -1, -1),
+                  SystemLocation()),
         MidiEvent(ticks,
                   { static_cast<uint8_t>(StatusByte::ControlChange + channel),
                     Controller::DataEntryFine, 0 },
-                  SystemLocation(), -1, -1),
+                  SystemLocation()),
     };
 }
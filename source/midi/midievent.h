@@ -20,7 +20,10 @@
 
 #include <score/systemlocation.h>
 
+#include <array>
+#include <boost/range/iterator_range_core.hpp>
 #include <cstdint>
+#include <initializer_list>
 #include <vector>
 
 class MidiEvent
@@ -42,10 +45,15 @@ public:
         return myTicks < other.myTicks;
     }
 
+    typedef boost::iterator_range<const uint8_t *> DataRange;
+
     int getTicks() const { return myTicks; }
     void setTicks(int ticks) { myTicks = ticks; }
-    uint8_t getStatusByte() const { return myData[0]; }
-    const std::vector<uint8_t> &getData() const { return myData; }
+    uint8_t getStatusByte() const { return getDataPtr()[0]; }
+    DataRange getData() const
+    {
+        return DataRange(getDataPtr(), getDataPtr() + mySize);
+    }
     const SystemLocation &getLocation() const { return myLocation; }
 
     bool isTempoChange() const;
@@ -71,15 +79,18 @@ public:
                                                   uint8_t semitones);
 
 private:
-    MidiEvent(int ticks, std::vector<uint8_t> data,
-              const SystemLocation &location, int player, int instrument);
+    MidiEvent(int ticks, std::initializer_list<uint8_t> data,
+              const SystemLocation &location);
 
-    int myTicks; // TODO - does this need to be 64-bit for absolute times?
-    std::vector<uint8_t> myData;
+    const uint8_t *getDataPtr() const { return myData.data(); }
+
+    /// The longest message that is generated (a tempo change).
+    static const int MAX_DATA_SIZE = 6;
 
+    int myTicks; // TODO - does this need to be 64-bit for absolute times?
     SystemLocation myLocation;
-    int myPlayer;
-    int myInstrument;
+    uint8_t mySize;
+    std::array<uint8_t, MAX_DATA_SIZE> myData;
 };
 
 #endif
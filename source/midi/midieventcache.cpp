@@ -0,0 +1,89 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "midieventcache.h"
+
+#include <limits>
+
+bool MidiEventCache::Key::operator==(const Key &other) const
+{
+    return myTempo == other.myTempo && myActiveBends == other.myActiveBends &&
+           myActivePlayers == other.myActivePlayers;
+}
+
+MidiEventCache::MidiEventCache() : myNumHits(0), myNumLookups(0)
+{
+}
+
+MidiEventCache::BarPtr MidiEventCache::find(
+    const MidiFile::LoadOptions &options, int system, int position,
+    const Key &key)
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    if (!myOptions || !(*myOptions == options))
+    {
+        myBars.clear();
+        myOptions = options;
+    }
+
+    ++myNumLookups;
+
+    auto bars = myBars.find(std::make_pair(system, position));
+    if (bars == myBars.end())
+        return nullptr;
+
+    for (auto &&bar : bars->second)
+    {
+        if (bar.first == key)
+        {
+            ++myNumHits;
+            return bar.second;
+        }
+    }
+
+    return nullptr;
+}
+
+void MidiEventCache::insert(int system, int position, const Key &key,
+                            const BarPtr &bar)
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+    myBars[std::make_pair(system, position)].push_back(
+        std::make_pair(key, bar));
+}
+
+void MidiEventCache::invalidateSystem(int system)
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    myBars.erase(myBars.lower_bound(std::make_pair(system - 1, 0)),
+                 myBars.upper_bound(std::make_pair(
+                     system + 1, std::numeric_limits<int>::max())));
+}
+
+void MidiEventCache::clear()
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+    myBars.clear();
+}
+
+std::pair<int, int> MidiEventCache::getHitCount() const
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+    return std::make_pair(myNumHits, myNumLookups);
+}
@@ -0,0 +1,95 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MIDI_MIDIEVENTCACHE_H
+#define MIDI_MIDIEVENTCACHE_H
+
+#include <boost/optional/optional.hpp>
+#include <map>
+#include <memory>
+#include <midi/midifile.h>
+#include <mutex>
+#include <score/playerchange.h>
+#include <utility>
+#include <vector>
+
+/// Caches the MIDI events that were generated for each bar of a score, so
+/// that playing the score again only needs to regenerate the bars in systems
+/// that have changed. This can be shared between threads.
+class MidiEventCache
+{
+public:
+    /// The state of playback at the start of a bar, which (along with the
+    /// contents of the system) determines the events for the bar.
+    struct Key
+    {
+        bool operator==(const Key &other) const;
+
+        int myTempo;
+        std::vector<uint8_t> myActiveBends;
+        boost::optional<PlayerChange> myActivePlayers;
+    };
+
+    /// The events for a bar, with timestamps relative to the start of the
+    /// bar, and the playback state at the end of the bar.
+    struct Bar
+    {
+        MidiEventList myMasterEvents;
+        std::vector<MidiEventList> myPlayerEvents;
+        MidiEventList myMetronomeEvents;
+        int myDuration;
+        int myTempo;
+        std::vector<uint8_t> myActiveBends;
+    };
+
+    typedef std::shared_ptr<const Bar> BarPtr;
+
+    MidiEventCache();
+
+    /// Returns the cached events for the bar, or null if the bar has not been
+    /// generated with the same options and starting state. If the options
+    /// are different from the previous lookups, the cache is cleared.
+    BarPtr find(const MidiFile::LoadOptions &options, int system, int position,
+                const Key &key);
+
+    void insert(int system, int position, const Key &key, const BarPtr &bar);
+
+    /// Removes the cached bars for the system. Ties can span across systems,
+    /// so the adjacent systems are also removed.
+    void invalidateSystem(int system);
+
+    /// Removes all cached bars.
+    void clear();
+
+    /// Returns the number of lookups that were found in the cache, and the
+    /// total number of lookups.
+    std::pair<int, int> getHitCount() const;
+
+private:
+    typedef std::vector<std::pair<Key, BarPtr>> BarList;
+
+    mutable std::mutex myMutex;
+    boost::optional<MidiFile::LoadOptions> myOptions;
+    /// The cached bars for each (system, position) of a barline. A bar can
+    /// be played several times with a different starting state (e.g. for
+    /// repeats), so there can be several versions of it.
+    std::map<std::pair<int, int>, BarList> myBars;
+    int myNumHits;
+    int myNumLookups;
+};
+
+#endif
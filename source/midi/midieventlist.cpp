@@ -19,12 +19,32 @@
 
 #include <algorithm>
 #include <cassert>
+#include <iterator>
 
 MidiEventList::MidiEventList(bool absolute_ticks)
     : myAbsoluteTicks(absolute_ticks)
 {
 }
 
+MidiEventList MidiEventList::merge(
+    const std::vector<const MidiEventList *> &lists)
+{
+    MidiEventList merged;
+
+    size_t total = 0;
+    for (const MidiEventList *list : lists)
+        total += list->size();
+    merged.myEvents.reserve(total);
+
+    for (MidiEventMerger merger(lists); !merger.isDone(); merger.next())
+    {
+        merged.myEvents.push_back(merger.getEvent());
+        merged.myEvents.back().setTicks(merger.getTicks());
+    }
+
+    return merged;
+}
+
 void MidiEventList::convertToDeltaTicks()
 {
     assert(myAbsoluteTicks);
@@ -35,11 +55,7 @@ void MidiEventList::convertToDeltaTicks()
 
     // First, sort by timestamp. Events for different voices may have been added
     // out of order.
-    std::stable_sort(myEvents.begin(), myEvents.end(),
-                     [](const MidiEvent &a, const MidiEvent &b)
-                     {
-                         return a.getTicks() < b.getTicks();
-                     });
+    sortByTicks();
 
     for (size_t i = myEvents.size() - 1; i >= 1; --i)
     {
@@ -67,3 +83,77 @@ void MidiEventList::concat(const MidiEventList &other)
     myEvents.insert(myEvents.end(), other.myEvents.begin(),
                     other.myEvents.end());
 }
+
+void MidiEventList::sortByTicks()
+{
+    std::stable_sort(myEvents.begin(), myEvents.end(),
+                     [](const MidiEvent &a, const MidiEvent &b)
+                     {
+                         return a.getTicks() < b.getTicks();
+                     });
+}
+
+void MidiEventList::moveEventsBefore(int ticks, MidiEventList &other)
+{
+    auto end = std::lower_bound(myEvents.begin(), myEvents.end(), ticks,
+                                [](const MidiEvent &event, int t)
+                                {
+                                    return event.getTicks() < t;
+                                });
+
+    other.myEvents.insert(other.myEvents.end(),
+                          std::make_move_iterator(myEvents.begin()),
+                          std::make_move_iterator(end));
+    myEvents.erase(myEvents.begin(), end);
+}
+
+MidiEventMerger::MidiEventMerger(
+    const std::vector<const MidiEventList *> &lists)
+{
+    myHeap.reserve(lists.size());
+
+    for (size_t i = 0; i < lists.size(); ++i)
+    {
+        const MidiEventList &list = *lists[i];
+        if (list.empty())
+            continue;
+
+        Cursor cursor;
+        cursor.myPos = list.begin();
+        cursor.myEnd = list.end();
+        cursor.myTicks = cursor.myPos->getTicks();
+        cursor.myListIndex = static_cast<int>(i);
+        cursor.myAbsoluteTicks = list.hasAbsoluteTicks();
+        myHeap.push_back(cursor);
+    }
+
+    std::make_heap(myHeap.begin(), myHeap.end(), &MidiEventMerger::compare);
+}
+
+void MidiEventMerger::next()
+{
+    std::pop_heap(myHeap.begin(), myHeap.end(), &MidiEventMerger::compare);
+
+    Cursor &cursor = myHeap.back();
+    ++cursor.myPos;
+    if (cursor.myPos == cursor.myEnd)
+        myHeap.pop_back();
+    else
+    {
+        if (cursor.myAbsoluteTicks)
+            cursor.myTicks = cursor.myPos->getTicks();
+        else
+            cursor.myTicks += cursor.myPos->getTicks();
+
+        std::push_heap(myHeap.begin(), myHeap.end(), &MidiEventMerger::compare);
+    }
+}
+
+bool MidiEventMerger::compare(const Cursor &a, const Cursor &b)
+{
+    // std::make_heap builds a max-heap, so the comparison is reversed.
+    if (a.myTicks != b.myTicks)
+        return a.myTicks > b.myTicks;
+    else
+        return a.myListIndex > b.myListIndex;
+}
@@ -26,6 +26,12 @@ class MidiEventList
 public:
     MidiEventList(bool absolute_ticks = true);
 
+    /// Merges the lists, which must each be sorted by timestamp, into a
+    /// single list with absolute ticks.
+    static MidiEventList merge(const std::vector<const MidiEventList *> &lists);
+
+    bool hasAbsoluteTicks() const { return myAbsoluteTicks; }
+
     /// Convert the MIDI events from absolute to delta ticks.
     void convertToDeltaTicks();
     /// Convert the MIDI events from delta to absolute ticks.
@@ -39,6 +45,17 @@ public:
 
     void concat(const MidiEventList &other);
 
+    /// Sorts the events by timestamp. The order of events with the same
+    /// timestamp is preserved.
+    void sortByTicks();
+
+    /// Moves the events before the given tick to the end of the other list.
+    /// The list must be sorted by timestamp.
+    void moveEventsBefore(int ticks, MidiEventList &other);
+
+    bool empty() const { return myEvents.empty(); }
+    size_t size() const { return myEvents.size(); }
+
     typedef std::vector<MidiEvent>::iterator iterator;
     typedef std::vector<MidiEvent>::const_iterator const_iterator;
 
@@ -52,4 +69,39 @@ private:
     bool myAbsoluteTicks;
 };
 
+/// Lazily merges several event lists, which must each be sorted by timestamp,
+/// into a single sequence ordered by absolute timestamp. Events with the same
+/// timestamp are ordered by the index of their list, which gives the same
+/// order as a stable sort of the concatenated lists. The lists can use either
+/// absolute or delta ticks.
+class MidiEventMerger
+{
+public:
+    explicit MidiEventMerger(const std::vector<const MidiEventList *> &lists);
+
+    /// Returns whether all of the events have been consumed.
+    bool isDone() const { return myHeap.empty(); }
+    /// Returns the current event.
+    const MidiEvent &getEvent() const { return *myHeap.front().myPos; }
+    /// Returns the absolute timestamp of the current event.
+    int getTicks() const { return myHeap.front().myTicks; }
+    /// Advances to the next event.
+    void next();
+
+private:
+    struct Cursor
+    {
+        MidiEventList::const_iterator myPos;
+        MidiEventList::const_iterator myEnd;
+        int myTicks;
+        int myListIndex;
+        bool myAbsoluteTicks;
+    };
+
+    /// Orders the heap so that the earliest event is at the front.
+    static bool compare(const Cursor &a, const Cursor &b);
+
+    std::vector<Cursor> myHeap;
+};
+
 #endif
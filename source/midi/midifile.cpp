@@ -17,9 +17,13 @@
   
 #include "midifile.h"
 
+#include "midieventcache.h"
 #include "repeatcontroller.h"
 
+#include <boost/range/adaptor/reversed.hpp>
 #include <boost/rational.hpp>
+#include <cassert>
+#include <limits>
 
 #include <score/generalmidi.h>
 #include <score/score.h>
@@ -68,6 +72,121 @@ static int getChannel(const ActivePlayer &player)
     return getChannel(player.getPlayerNumber());
 }
 
+/// Returns the number of microseconds per quarter note for the tempo marker.
+static int getTempo(const TempoMarker &marker)
+{
+    // Convert the values in the TempoMarker::BeatType enum to a factor that
+    // will scale the bpm value to be in terms of quarter notes.
+    boost::rational<int> scale(2, 1 << (marker.getBeatType() / 2));
+    if (marker.getBeatType() % 2 != 0)
+        scale *= boost::rational<int>(3, 2);
+
+    // Compute the number of microseconds per quarter note.
+    return boost::rational_cast<int>(
+        60000000 / (scale * marker.getBeatsPerMinute()));
+}
+
+/// Returns the tempo at the start of the bar, which is set by the last tempo
+/// marker in the preceding bars.
+static int findTempo(const Score &score, const SystemLocation &bar)
+{
+    for (int i = bar.getSystem(); i >= 0; --i)
+    {
+        const System &system = score.getSystems()[i];
+        // Tempo markers after the system's last barline are never played.
+        const int end = (i == bar.getSystem())
+                            ? bar.getPosition()
+                            : system.getBarlines().back().getPosition();
+
+        for (const TempoMarker &marker :
+             boost::adaptors::reverse(system.getTempoMarkers()))
+        {
+            if (marker.getPosition() < end)
+                return getTempo(marker);
+        }
+    }
+
+    return Midi::BEAT_DURATION_120_BPM;
+}
+
+/// Returns the pitch bend that is held on the staff at the start of the bar
+/// (e.g. from a "bend and hold" in an earlier bar).
+static uint8_t findActiveBend(const Score &score, const SystemLocation &bar,
+                              int staff_index)
+{
+    for (int i = bar.getSystem(); i >= 0; --i)
+    {
+        const System &system = score.getSystems()[i];
+        const int end = (i == bar.getSystem())
+                            ? bar.getPosition()
+                            : system.getBarlines().back().getPosition();
+
+        // The voices of a bar are generated one after another, so the last
+        // bend in the last voice of the latest bar takes effect.
+        int bend_bar = -1;
+        const Note *bend_note = nullptr;
+        for (const Voice &voice : system.getStaves()[staff_index].getVoices())
+        {
+            for (const Position &pos :
+                 boost::adaptors::reverse(voice.getPositions()))
+            {
+                if (pos.getPosition() >= end || pos.isRest())
+                    continue;
+
+                const Note *note = nullptr;
+                for (const Note &n : pos.getNotes())
+                {
+                    if (n.hasBend())
+                        note = &n;
+                }
+
+                // Notes without any active players are treated as rests.
+                const PlayerChange *players = ScoreUtils::getCurrentPlayers(
+                    score, i, pos.getPosition());
+                if (!note || !players ||
+                    players->getActivePlayers(staff_index).empty())
+                {
+                    continue;
+                }
+
+                const int pos_bar =
+                    system.getPreviousBarline(pos.getPosition() + 1)
+                        ->getPosition();
+                if (pos_bar >= bend_bar)
+                {
+                    bend_bar = pos_bar;
+                    bend_note = note;
+                }
+                break;
+            }
+        }
+
+        if (bend_note)
+        {
+            const Bend &bend = bend_note->getBend();
+            if (bend.getType() != Bend::BendAndHold &&
+                bend.getType() != Bend::PreBendAndHold)
+            {
+                return DEFAULT_BEND;
+            }
+
+            return boost::rational_cast<int>(
+                DEFAULT_BEND + bend.getBentPitch() * BEND_QUARTER_TONE);
+        }
+
+        // The bend is only carried over from the previous system if it also
+        // had this staff.
+        if (i == 0 ||
+            staff_index >=
+                static_cast<int>(score.getSystems()[i - 1].getStaves().size()))
+        {
+            break;
+        }
+    }
+
+    return DEFAULT_BEND;
+}
+
 static bool findPositionChange(MidiEventList &event_list, int ticks,
                                bool record_position_changes,
                                RepeatController &repeat_controller,
@@ -125,21 +244,78 @@ static SystemLocation moveToNextBar(MidiEventList &event_list, int ticks,
     return location;
 }
 
+struct MidiFile::LoadState
+{
+    LoadState(const Score &score, const LoadOptions &options,
+              MidiEventCache *cache)
+        : myScore(score),
+          myOptions(options),
+          myCache(cache),
+          myRepeatController(score),
+          myRegularTracks(score.getPlayers().size()),
+          myLocation(0, 0),
+          mySystemIndex(-1),
+          myCurrentTick(0),
+          myCurrentTempo(Midi::BEAT_DURATION_120_BPM),
+          myPrevBarStart(0),
+          myHorizon(0),
+          myIsFinished(false)
+    {
+    }
+
+    const Score &myScore;
+    const LoadOptions myOptions;
+    MidiEventCache *myCache;
+    RepeatController myRepeatController;
+
+    MidiEventList myMasterTrack;
+    std::vector<MidiEventList> myRegularTracks;
+    MidiEventList myMetronomeTrack;
+
+    SystemLocation myLocation;
+    std::vector<uint8_t> myActiveBends;
+    int mySystemIndex;
+    int myCurrentTick;
+    int myCurrentTempo;
+
+    /// The start of the most recently generated bar.
+    int myPrevBarStart;
+    /// Events before this tick cannot be affected by any bars that have not
+    /// been generated yet. Grace notes can be placed slightly before the
+    /// start of their bar, so this lags one bar behind.
+    int myHorizon;
+    bool myIsFinished;
+};
+
 MidiFile::MidiFile() : myTicksPerBeat(0)
 {
 }
 
+MidiFile::~MidiFile()
+{
+}
+
 void MidiFile::load(const Score &score, const LoadOptions &options)
 {
-    myTicksPerBeat = DEFAULT_PPQ;
+    beginLoad(score, options);
+
+    while (loadNextBar())
+        ;
 
-    RepeatController repeat_controller(score);
+    for (MidiEventList &track : myTracks)
+        track.convertToDeltaTicks();
+}
 
-    MidiEventList master_track;
-    MidiEventList metronome_track;
+void MidiFile::beginLoad(const Score &score, const LoadOptions &options,
+                         MidiEventCache *cache,
+                         const SystemLocation &start_location)
+{
+    myTicksPerBeat = DEFAULT_PPQ;
+    myTracks.clear();
+    myLoadState.reset(new LoadState(score, options, cache));
 
     // Set the initial channel volume and pitch bend range..
-    std::vector<MidiEventList> regular_tracks(score.getPlayers().size());
+    std::vector<MidiEventList> &regular_tracks = myLoadState->myRegularTracks;
     for (unsigned int i = 0; i < score.getPlayers().size(); ++i)
     {
         regular_tracks[i].append(
@@ -153,69 +329,236 @@ void MidiFile::load(const Score &score, const LoadOptions &options)
 
     }
 
-    SystemLocation location(0, 0);
-    std::vector<uint8_t> active_bends;
-    int system_index = -1;
-    int current_tick = 0;
-    int current_tempo = Midi::BEAT_DURATION_120_BPM;
+    if (start_location.getSystem() < score.getSystems().size())
+    {
+        // Start from the bar containing the location. A location at the end
+        // of the system is part of the system's last bar.
+        const System &system = score.getSystems()[start_location.getSystem()];
+        const Barline *bar =
+            system.getPreviousBarline(start_location.getPosition() + 1);
+        if (bar == &system.getBarlines().back())
+            bar = system.getPreviousBarline(bar->getPosition());
+
+        seekToBar(
+            SystemLocation(start_location.getSystem(), bar->getPosition()));
+    }
+}
 
-    while (location.getSystem() < score.getSystems().size())
+void MidiFile::seekToBar(const SystemLocation &location)
+{
+    LoadState &state = *myLoadState;
+    const Score &score = state.myScore;
+    const System &system = score.getSystems()[location.getSystem()];
+
+    // Rather than generating the earlier bars, find the tempo and held bends
+    // that they would have left behind.
+    state.myLocation = location;
+    state.mySystemIndex = location.getSystem();
+    state.myCurrentTempo = findTempo(score, location);
+    state.myActiveBends.clear();
+    for (int i = 0; i < static_cast<int>(system.getStaves().size()); ++i)
+        state.myActiveBends.push_back(findActiveBend(score, location, i));
+
+    if (state.myCurrentTempo != Midi::BEAT_DURATION_120_BPM)
     {
-        const System &system = score.getSystems()[location.getSystem()];
-        const Barline *current_bar = ScoreUtils::findByPosition(
-            system.getBarlines(), location.getPosition());
-        const Barline *next_bar = system.getNextBarline(location.getPosition());
+        state.myMasterTrack.append(
+            MidiEvent::setTempo(0, state.myCurrentTempo));
+    }
 
-        if (location.getSystem() != system_index)
+    // Select the instruments from any earlier player change. A player change
+    // at the start of the bar is handled when the bar is generated.
+    const PlayerChange *players = ScoreUtils::getCurrentPlayers(
+        score, location.getSystem(), location.getPosition() - 1);
+    if (players)
+    {
+        for (int i = 0; i < static_cast<int>(system.getStaves().size()); ++i)
         {
-            active_bends.resize(system.getStaves().size(), DEFAULT_BEND);
-            system_index = location.getSystem();
+            for (const ActivePlayer &player : players->getActivePlayers(i))
+            {
+                const Instrument &instrument =
+                    score.getInstruments()[player.getInstrumentNumber()];
+
+                state.myRegularTracks[player.getPlayerNumber()].append(
+                    MidiEvent::programChange(0, getChannel(player),
+                                             instrument.getMidiPreset()));
+            }
         }
+    }
+}
+
+bool MidiFile::loadNextBar()
+{
+    assert(myLoadState);
+    LoadState &state = *myLoadState;
+    if (state.myIsFinished)
+        return false;
+
+    const Score &score = state.myScore;
+    const LoadOptions &options = state.myOptions;
+    SystemLocation &location = state.myLocation;
+    int &current_tick = state.myCurrentTick;
+
+    if (location.getSystem() >= score.getSystems().size())
+    {
+        finishLoad();
+        return false;
+    }
+
+    const System &system = score.getSystems()[location.getSystem()];
+    const Barline *current_bar = ScoreUtils::findByPosition(
+        system.getBarlines(), location.getPosition());
+    const Barline *next_bar = system.getNextBarline(location.getPosition());
 
-        const int start_tick = current_tick;
-        current_tempo =
-            addTempoEvent(master_track, start_tick, current_tempo, system,
-                          current_bar->getPosition(), next_bar->getPosition());
+    if (location.getSystem() != state.mySystemIndex)
+    {
+        state.myActiveBends.resize(system.getStaves().size(), DEFAULT_BEND);
+        state.mySystemIndex = location.getSystem();
+    }
+
+    const int start_tick = current_tick;
+    state.myHorizon = state.myPrevBarStart;
+    state.myPrevBarStart = start_tick;
+
+    // Reuse the events from the last time the bar was played, if possible.
+    MidiEventCache::BarPtr bar;
+    MidiEventCache::Key key;
+    if (state.myCache)
+    {
+        key.myTempo = state.myCurrentTempo;
+        key.myActiveBends = state.myActiveBends;
+        const PlayerChange *players = ScoreUtils::getCurrentPlayers(
+            score, location.getSystem(), current_bar->getPosition());
+        if (players)
+            key.myActivePlayers = *players;
+
+        bar = state.myCache->find(options, location.getSystem(),
+                                  current_bar->getPosition(), key);
+    }
 
-        for (unsigned int staff_index = 0; staff_index < system.getStaves().size();
-             ++staff_index)
+    if (!bar)
+    {
+        // Generate the events relative to the start of the bar.
+        auto new_bar = std::make_shared<MidiEventCache::Bar>();
+        new_bar->myPlayerEvents.resize(state.myRegularTracks.size());
+        new_bar->myActiveBends = state.myActiveBends;
+
+        new_bar->myTempo = addTempoEvent(
+            new_bar->myMasterEvents, 0, state.myCurrentTempo, system,
+            current_bar->getPosition(), next_bar->getPosition());
+
+        int end_tick = 0;
+        for (unsigned int staff_index = 0;
+             staff_index < system.getStaves().size(); ++staff_index)
         {
             const Staff &staff = system.getStaves()[staff_index];
 
-            for (unsigned int voice_index = 0; voice_index < staff.getVoices().size();
-                 ++voice_index)
+            for (unsigned int voice_index = 0;
+                 voice_index < staff.getVoices().size(); ++voice_index)
             {
-                const int end_tick = addEventsForBar(
-                    regular_tracks, active_bends[staff_index], start_tick,
-                    current_tempo, score, system, location.getSystem(), staff,
-                    staff_index, staff.getVoices()[voice_index], voice_index,
-                    current_bar->getPosition(), next_bar->getPosition(),
-                    options);
-
-                current_tick = std::max(current_tick, end_tick);
+                end_tick = std::max(
+                    end_tick,
+                    addEventsForBar(
+                        new_bar->myPlayerEvents,
+                        new_bar->myActiveBends[staff_index], 0,
+                        new_bar->myTempo, score, system, location.getSystem(),
+                        staff, staff_index, staff.getVoices()[voice_index],
+                        voice_index, current_bar->getPosition(),
+                        next_bar->getPosition(), options));
             }
         }
 
         // Generate metronome events.
-        current_tick = std::max(
-            current_tick,
-            generateMetronome(metronome_track, start_tick, system, *current_bar,
-                              *next_bar, location, options));
+        end_tick = std::max(
+            end_tick,
+            generateMetronome(new_bar->myMetronomeEvents, 0, system,
+                              *current_bar, *next_bar, location, options));
 
-        location = moveToNextBar(
-            metronome_track, current_tick, options.myRecordPositionChanges,
-            system, location, next_bar->getPosition(), repeat_controller);
+        new_bar->myDuration = end_tick;
+        bar = new_bar;
+
+        if (state.myCache)
+        {
+            state.myCache->insert(location.getSystem(),
+                                  current_bar->getPosition(), key, bar);
+        }
     }
 
-    myTracks.push_back(master_track);
-    myTracks.insert(myTracks.end(), regular_tracks.begin(), regular_tracks.end());
-    if (options.myEnableMetronome)
-        myTracks.push_back(metronome_track);
+    // Add the bar's events to the tracks.
+    auto append = [=](MidiEventList &track, const MidiEventList &events) {
+        for (MidiEvent event : events)
+        {
+            event.setTicks(event.getTicks() + start_tick);
+            track.append(std::move(event));
+        }
+    };
+
+    append(state.myMasterTrack, bar->myMasterEvents);
+    for (size_t i = 0; i < bar->myPlayerEvents.size(); ++i)
+        append(state.myRegularTracks[i], bar->myPlayerEvents[i]);
+    append(state.myMetronomeTrack, bar->myMetronomeEvents);
+
+    current_tick = start_tick + bar->myDuration;
+    state.myCurrentTempo = bar->myTempo;
+    state.myActiveBends = bar->myActiveBends;
+
+    location = moveToNextBar(state.myMetronomeTrack, current_tick,
+                             options.myRecordPositionChanges, system, location,
+                             next_bar->getPosition(),
+                             state.myRepeatController);
+    return true;
+}
+
+void MidiFile::finishLoad()
+{
+    LoadState &state = *myLoadState;
+    state.myIsFinished = true;
+    state.myHorizon = std::numeric_limits<int>::max();
+
+    myTracks.push_back(std::move(state.myMasterTrack));
+    for (MidiEventList &track : state.myRegularTracks)
+        myTracks.push_back(std::move(track));
+    if (state.myOptions.myEnableMetronome)
+        myTracks.push_back(std::move(state.myMetronomeTrack));
 
     for (MidiEventList &track : myTracks)
+        track.append(MidiEvent::endOfTrack(state.myCurrentTick));
+}
+
+void MidiFile::takeCompletedEvents(MidiEventList &events)
+{
+    assert(myLoadState);
+    LoadState &state = *myLoadState;
+
+    // Gather the tracks in the same order that they are written out.
+    std::vector<MidiEventList *> tracks;
+    if (state.myIsFinished)
     {
-        track.append(MidiEvent::endOfTrack(current_tick));
-        track.convertToDeltaTicks();
+        for (MidiEventList &track : myTracks)
+            tracks.push_back(&track);
+    }
+    else
+    {
+        tracks.push_back(&state.myMasterTrack);
+        for (MidiEventList &track : state.myRegularTracks)
+            tracks.push_back(&track);
+        if (state.myOptions.myEnableMetronome)
+            tracks.push_back(&state.myMetronomeTrack);
+    }
+
+    std::vector<MidiEventList> completed(tracks.size());
+    std::vector<const MidiEventList *> completed_lists;
+    for (size_t i = 0; i < tracks.size(); ++i)
+    {
+        tracks[i]->sortByTicks();
+        tracks[i]->moveEventsBefore(state.myHorizon, completed[i]);
+        completed_lists.push_back(&completed[i]);
+    }
+
+    // Each track is sorted, so they can be merged rather than sorting again.
+    for (MidiEventMerger merger(completed_lists); !merger.isDone();
+         merger.next())
+    {
+        events.append(merger.getEvent());
     }
 }
 
@@ -288,18 +631,7 @@ int MidiFile::addTempoEvent(MidiEventList &event_list, int current_tick,
     // If multiple tempo markers occur in a bar, just choose the last one.
     if (!markers.empty())
     {
-        const TempoMarker &marker = markers.back();
-
-        // Convert the values in the TempoMarker::BeatType enum to a factor that
-        // will scale the bpm value to be in terms of quarter notes.
-        boost::rational<int> scale(2, 1 << (marker.getBeatType() / 2));
-        if (marker.getBeatType() % 2 != 0)
-            scale *= boost::rational<int>(3, 2);
-
-        // Compute the number of microseconds per quarter note.
-        current_tempo = boost::rational_cast<int>(
-            60000000 / (scale * marker.getBeatsPerMinute()));
-
+        current_tempo = getTempo(markers.back());
         event_list.append(MidiEvent::setTempo(current_tick, current_tempo));
     }
 
@@ -21,13 +21,15 @@
 #include <midi/midieventlist.h>
 
 #include <cstdint>
+#include <memory>
+#include <score/systemlocation.h>
 #include <vector>
 
 class Barline;
+class MidiEventCache;
 class Score;
 class Staff;
 class System;
-class SystemLocation;
 class Voice;
 
 class MidiFile
@@ -46,6 +48,17 @@ public:
         {
         }
 
+        bool operator==(const LoadOptions &other) const
+        {
+            return myVibratoStrength == other.myVibratoStrength &&
+                   myWideVibratoStrength == other.myWideVibratoStrength &&
+                   myEnableMetronome == other.myEnableMetronome &&
+                   myStrongAccentVel == other.myStrongAccentVel &&
+                   myWeakAccentVel == other.myWeakAccentVel &&
+                   myMetronomePreset == other.myMetronomePreset &&
+                   myRecordPositionChanges == other.myRecordPositionChanges;
+        }
+
         uint8_t myVibratoStrength;
         uint8_t myWideVibratoStrength;
         bool myEnableMetronome;
@@ -56,14 +69,46 @@ public:
     };
 
     MidiFile();
+    ~MidiFile();
 
+    /// Generates all of the MIDI events for the score.
     void load(const Score &score, const LoadOptions &options);
 
+    /// Prepares to generate the MIDI events for the score one bar at a time
+    /// with loadNextBar(), so that the events at the start of the score can
+    /// be used before the entire score has been processed. If a cache is
+    /// provided, the events for bars that have not changed since they were
+    /// cached are reused.
+    /// Generation begins at the start of the bar containing the start
+    /// location, with the tempo, instruments and held bends that are in
+    /// effect there, so the earlier bars do not need to be generated.
+    void beginLoad(
+        const Score &score, const LoadOptions &options,
+        MidiEventCache *cache = nullptr,
+        const SystemLocation &start_location = SystemLocation(0, 0));
+
+    /// Generates the events for the next bar of the score. Returns false
+    /// once the end of the score has been reached.
+    bool loadNextBar();
+
+    /// Moves the events that can no longer be affected by the bars that have
+    /// not been generated yet into the given list. The events from all
+    /// tracks are merged together, in order of their (absolute) timestamp.
+    void takeCompletedEvents(MidiEventList &events);
+
     int getTicksPerBeat() const { return myTicksPerBeat; }
     std::vector<MidiEventList> &getTracks() { return myTracks; }
     const std::vector<MidiEventList> &getTracks() const { return myTracks; }
 
 private:
+    struct LoadState;
+
+    /// Sets up the load state to begin at the start of the given bar.
+    void seekToBar(const SystemLocation &location);
+
+    /// Adds the end of track events, and moves the tracks into myTracks.
+    void finishLoad();
+
     int generateMetronome(MidiEventList &event_list, int current_tick,
                           const System &system, const Barline &current_bar,
                           const Barline &next_bar,
@@ -84,6 +129,8 @@ private:
 
     int myTicksPerBeat;
     std::vector<MidiEventList> myTracks;
+    /// The state of the generator when loading one bar at a time.
+    std::unique_ptr<LoadState> myLoadState;
 };
 
 #endif
@@ -18,11 +18,10 @@
 #include "beamgroup.h"
 
 #include <cmath>
+#include <painters/displaylistitem.h>
 #include <painters/layoutinfo.h>
 #include <painters/musicfont.h>
-#include <painters/simpletextitem.h>
-#include <QFontMetricsF>
-#include <QGraphicsItem>
+#include <painters/textcache.h>
 #include <QPainterPath>
 #include <QPen>
 
@@ -42,12 +41,11 @@ BeamGroup::BeamGroup(NoteStem::StemType direction,
 {
 }
 
-void BeamGroup::drawStems(QGraphicsItem *parent,
+void BeamGroup::drawStems(DisplayListItem &displayList,
                           const std::vector<NoteStem> &stems,
-                          const QFont &musicFont, const QFontMetricsF &fm,
+                          const QFont &musicFont,
                           const LayoutInfo &layout) const
 {
-    QList<QGraphicsItem *> symbols;
     QPainterPath stemPath;
 
     std::vector<NoteStem> group_stems;
@@ -68,22 +66,16 @@ void BeamGroup::drawStems(QGraphicsItem *parent,
         // Draw any symbols that use information about the stem, like staccato,
         // fermata, etc.
         if (stem.isStaccato())
-            symbols << createStaccato(stem, musicFont, fm);
+            drawStaccato(displayList, stem, musicFont);
 
         if (stem.hasFermata())
-            symbols << createFermata(stem, musicFont, layout);
+            drawFermata(displayList, stem, musicFont, layout);
 
         if (stem.hasSforzando() || stem.hasMarcato())
-            symbols << createAccent(stem, musicFont, layout);
-
-        for (QGraphicsItem *symbol : symbols)
-            symbol->setParentItem(parent);
-
-        symbols.clear();
+            drawAccent(displayList, stem, musicFont, layout);
     }
 
-    auto stemPathItem = new QGraphicsPathItem(stemPath);
-    stemPathItem->setParentItem(parent);
+    displayList.addPath(stemPath);
 
     QPainterPath beamPath;
 
@@ -98,16 +90,12 @@ void BeamGroup::drawStems(QGraphicsItem *parent,
 
     drawExtraBeams(beamPath, begin, end);
 
-    auto beams = new QGraphicsPathItem(beamPath);
-    beams->setPen(QPen(Qt::black, 2.0, Qt::SolidLine, Qt::RoundCap));
-    beams->setParentItem(parent);
+    displayList.addPath(beamPath,
+                        QPen(Qt::black, 2.0, Qt::SolidLine, Qt::RoundCap));
 
     // Draw a note flag for single notes (eighth notes or less) or grace notes.
     if (group_stems.size() == 1 && NoteStem::canHaveFlag(firstStem))
-    {
-        QGraphicsItem *flag = createNoteFlag(firstStem, musicFont, fm);
-        flag->setParentItem(parent);
-    }
+        drawNoteFlag(displayList, firstStem, musicFont);
 }
 
 void BeamGroup::drawExtraBeams(QPainterPath &path,
@@ -174,30 +162,29 @@ void BeamGroup::drawExtraBeams(QPainterPath &path,
 
 }
 
-QGraphicsItem *BeamGroup::createStaccato(const NoteStem &stem,
-                                         const QFont &musicFont,
-                                         const QFontMetricsF &fm)
+void BeamGroup::drawStaccato(DisplayListItem &displayList,
+                             const NoteStem &stem, const QFont &musicFont)
 {
     // Draw the dot near either the top or bottom note of the position,
     // depending on stem direction.
     const double VERTICAL_SPACING = 8;
+    const double ascent = TextCache::getAscent(musicFont);
     const double yPos = (stem.getStemType() == NoteStem::StemUp)
-                            ? stem.getBottom() - fm.ascent() + VERTICAL_SPACING
-                            : stem.getTop() - fm.ascent() - VERTICAL_SPACING;
+                            ? stem.getBottom() - ascent + VERTICAL_SPACING
+                            : stem.getTop() - ascent - VERTICAL_SPACING;
 
     const double HORIZONTAL_OFFSET = 3;
     const double xPos = (stem.getStemType() == NoteStem::StemUp)
                             ? stem.getX() - HORIZONTAL_OFFSET
                             : stem.getX() + HORIZONTAL_OFFSET;
 
-    auto dot = new SimpleTextItem(QChar(MusicFont::Dot), musicFont);
-    dot->setPos(xPos, yPos);
-    return dot;
+    displayList.addText(TextCache::get(musicFont, QChar(MusicFont::Dot)),
+                        QPointF(xPos, yPos));
 }
 
-QGraphicsItem *BeamGroup::createFermata(const NoteStem &stem,
-                                        const QFont &musicFont,
-                                        const LayoutInfo &layout)
+void BeamGroup::drawFermata(DisplayListItem &displayList,
+                            const NoteStem &stem, const QFont &musicFont,
+                            const LayoutInfo &layout)
 {
     double y = 0;
 
@@ -218,15 +205,13 @@ QGraphicsItem *BeamGroup::createFermata(const NoteStem &stem,
 
     const QChar symbol = (stem.getStemType() == NoteStem::StemUp) ?
                 MusicFont::FermataUp : MusicFont::FermataDown;
-    auto fermata = new SimpleTextItem(symbol, musicFont);
-    fermata->setPos(stem.getX(), y);
-
-    return fermata;
+    displayList.addText(TextCache::get(musicFont, symbol),
+                        QPointF(stem.getX(), y));
 }
 
-QGraphicsItem *BeamGroup::createAccent(const NoteStem &stem,
-                                       const QFont &musicFont,
-                                       const LayoutInfo &layout)
+void BeamGroup::drawAccent(DisplayListItem &displayList,
+                           const NoteStem &stem, const QFont &musicFont,
+                           const LayoutInfo &layout)
 {
     double y = 0;
 
@@ -258,15 +243,12 @@ QGraphicsItem *BeamGroup::createAccent(const NoteStem &stem,
     if (stem.isStaccato())
         y += (stem.getStemType() == NoteStem::StemUp) ? 7 : -7;
 
-    auto accent = new SimpleTextItem(symbol, musicFont);
-    accent->setPos(stem.getX(), y);
-
-    return accent;
+    displayList.addText(TextCache::get(musicFont, symbol),
+                        QPointF(stem.getX(), y));
 }
 
-QGraphicsItem *BeamGroup::createNoteFlag(const NoteStem &stem,
-                                         const QFont &musicFont,
-                                         const QFontMetricsF &fm)
+void BeamGroup::drawNoteFlag(DisplayListItem &displayList,
+                             const NoteStem &stem, const QFont &musicFont)
 {
     Q_ASSERT(NoteStem::canHaveFlag(stem));
 
@@ -321,26 +303,18 @@ QGraphicsItem *BeamGroup::createNoteFlag(const NoteStem &stem,
     }
 
     // Draw the symbol.
-    const double y = stem.getStemEdge() - fm.ascent();
-    auto flag = new SimpleTextItem(symbol, musicFont);
-    flag->setPos(stem.getX() + 2, y);
+    const double y = stem.getStemEdge() - TextCache::getAscent(musicFont);
+    displayList.addText(TextCache::get(musicFont, symbol),
+                        QPointF(stem.getX() + 2, y));
 
     // For grace notes, add a slash through the stem.
     if (stem.isGraceNote())
     {
-        auto group = new QGraphicsItemGroup();
-        group->addToGroup(flag);
-
         const QChar slash_symbol = stem.getStemType() == NoteStem::StemUp
                                        ? MusicFont::GraceNoteSlashUp
                                        : MusicFont::GraceNoteSlashDown;
 
-        auto slash = new SimpleTextItem(slash_symbol, musicFont);
-        slash->setPos(stem.getX() + 1, y);
-        group->addToGroup(slash);
-
-        return group;
+        displayList.addText(TextCache::get(musicFont, slash_symbol),
+                            QPointF(stem.getX() + 1, y));
     }
-    else
-        return flag;
 }
@@ -21,10 +21,9 @@
 #include <painters/notestem.h>
 #include <vector>
 
+class DisplayListItem;
 struct LayoutInfo;
 class QFont;
-class QFontMetricsF;
-class QGraphicsItem;
 class QPainterPath;
 
 class BeamGroup
@@ -33,8 +32,8 @@ public:
     BeamGroup(NoteStem::StemType direction, const std::vector<size_t> &stems);
 
     /// Draws the stems for each note in the group.
-    void drawStems(QGraphicsItem *parent, const std::vector<NoteStem> &stems,
-                   const QFont &musicFont, const QFontMetricsF &fm,
+    void drawStems(DisplayListItem &displayList,
+                   const std::vector<NoteStem> &stems, const QFont &musicFont,
                    const LayoutInfo &layout) const;
 
 private:
@@ -43,24 +42,21 @@ private:
                         std::vector<NoteStem>::const_iterator begin,
                         std::vector<NoteStem>::const_iterator end) const;
 
-    /// Creates and positions a staccato symbol.
-    static QGraphicsItem *createStaccato(const NoteStem& stem,
-                                         const QFont &musicFont,
-                                         const QFontMetricsF &fm);
+    /// Draws a staccato symbol.
+    static void drawStaccato(DisplayListItem &displayList,
+                             const NoteStem &stem, const QFont &musicFont);
 
-    /// Creates and positions a fermata symbol.
-    static QGraphicsItem *createFermata(const NoteStem& noteStem,
-                                        const QFont &musicFont,
-                                        const LayoutInfo &layout);
+    /// Draws a fermata symbol.
+    static void drawFermata(DisplayListItem &displayList,
+                            const NoteStem &noteStem, const QFont &musicFont,
+                            const LayoutInfo &layout);
 
-    /// Creates and positions an accent symbol.
-    static QGraphicsItem *createAccent(const NoteStem& stem,
-                                       const QFont &musicFont,
-                                       const LayoutInfo &layout);
+    /// Draws an accent symbol.
+    static void drawAccent(DisplayListItem &displayList, const NoteStem &stem,
+                           const QFont &musicFont, const LayoutInfo &layout);
 
-    static QGraphicsItem *createNoteFlag(const NoteStem& stem,
-                                         const QFont &musicFont,
-                                         const QFontMetricsF &fm);
+    static void drawNoteFlag(DisplayListItem &displayList,
+                             const NoteStem &stem, const QFont &musicFont);
 
     NoteStem::StemType myStemDirection;
     std::vector<size_t> myStems;
@@ -21,6 +21,7 @@
 #include <app/viewoptions.h>
 #include <boost/lexical_cast.hpp>
 #include <painters/layoutinfo.h>
+#include <painters/systemoffsets.h>
 #include <QDebug>
 #include <QGraphicsScene>
 #include <QGraphicsView>
@@ -32,9 +33,11 @@
 const double CaretPainter::PEN_WIDTH = 0.75;
 const double CaretPainter::CARET_NOTE_SPACING = 6;
 
-CaretPainter::CaretPainter(const Caret &caret, const ViewOptions &view_options)
+CaretPainter::CaretPainter(const Caret &caret, const ViewOptions &view_options,
+                           const SystemOffsets &system_offsets)
     : myCaret(caret),
       myViewOptions(view_options),
+      mySystemOffsets(system_offsets),
       myCaretConnection(caret.subscribeToChanges([=]() {
           onLocationChanged();
       }))
@@ -130,19 +133,11 @@ QRectF CaretPainter::boundingRect() const
         return QRectF();
 }
 
-void CaretPainter::addSystemRect(const QRectF &rect)
-{
-    mySystemRects.push_back(rect);
-}
-
-void CaretPainter::setSystemRect(int index, const QRectF &rect)
-{
-    mySystemRects.at(index) = rect;
-}
-
 QRectF CaretPainter::getCurrentSystemRect() const
 {
-    return mySystemRects.at(myCaret.getLocation().getSystemIndex());
+    const int system = myCaret.getLocation().getSystemIndex();
+    return QRectF(0, mySystemOffsets.getTop(system), LayoutInfo::STAFF_WIDTH,
+                  mySystemOffsets.getHeight(system));
 }
 
 void CaretPainter::updatePosition()
@@ -190,7 +185,7 @@ void CaretPainter::onLocationChanged()
     }
 
     const QRectF oldRect = sceneBoundingRect();
-    setPos(0, mySystemRects.at(location.getSystemIndex()).top() + offset +
+    setPos(0, mySystemOffsets.getTop(location.getSystemIndex()) + offset +
            myLayout->getSystemSymbolSpacing() + myLayout->getStaffHeight() -
            myLayout->getTabStaffBelowSpacing() - myLayout->STAFF_BORDER_SPACING -
            myLayout->getTabStaffHeight());
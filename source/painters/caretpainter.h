@@ -24,20 +24,20 @@
 
 class Caret;
 struct LayoutInfo;
+class SystemOffsets;
 class ViewOptions;
 
 class CaretPainter : public QGraphicsItem
 {
 public:
-    CaretPainter(const Caret &caret, const ViewOptions &view_options);
+    CaretPainter(const Caret &caret, const ViewOptions &view_options,
+                 const SystemOffsets &system_offsets);
 
     virtual void paint(QPainter *painter, const QStyleOptionGraphicsItem *,
                        QWidget *) override;
 
     virtual QRectF boundingRect() const override;
 
-    void addSystemRect(const QRectF &rect);
-    void setSystemRect(int index, const QRectF &rect);
     QRectF getCurrentSystemRect() const;
 
     void updatePosition();
@@ -53,8 +53,8 @@ private:
 
     const Caret &myCaret;
     const ViewOptions &myViewOptions;
+    const SystemOffsets &mySystemOffsets;
     std::unique_ptr<LayoutInfo> myLayout;
-    std::vector<QRectF> mySystemRects;
     boost::signals2::scoped_connection myCaretConnection;
     LocationChangedSlot onMyLocationChanged;
 
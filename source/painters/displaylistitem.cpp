@@ -0,0 +1,368 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#include "displaylistitem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <painters/simpletextitem.h>
+#include <QCursor>
+#include <QGraphicsSceneMouseEvent>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+
+/// Width of the vertical strips used to look up click and hover targets.
+static const double REGION_BUCKET_WIDTH = 32;
+
+/// Pens and brushes are shared between commands, but don't bother searching
+/// for duplicates in long lists.
+static const size_t MAX_SHARED_PAINT_STATE = 32;
+
+/// Returns the area covered when stroking the outline of the rectangle, in
+/// the same way as the bounding rectangle of a QGraphicsLineItem, etc.
+static QRectF getStrokeBounds(const QRectF &rect, const QPen &pen)
+{
+    const double half_width =
+        pen.style() == Qt::NoPen ? 0 : 0.5 * pen.widthF();
+    return rect.adjusted(-half_width, -half_width, half_width, half_width);
+}
+
+DisplayListItem::DisplayListItem() : myHoverRegion(-1), myPressedRegion(-1)
+{
+    // Provides the exposed rectangle, so that only the visible commands are
+    // drawn.
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+
+    // Let mouse events pass through to the items below (e.g. the staff, for
+    // making selections) unless there is something to click on.
+    setAcceptedMouseButtons(Qt::NoButton);
+}
+
+QRectF DisplayListItem::addText(const CachedTextPtr &text, const QPointF &pos,
+                                const QPen &pen, const QBrush &background)
+{
+    myTexts.push_back(text);
+
+    const QRectF bounds(pos, QSizeF(text->getWidth(), text->getHeight()));
+    Command &command =
+        addCommand(CommandType::Text, static_cast<int>(myTexts.size() - 1),
+                   pen, background, bounds);
+    command.myOffset = pos;
+
+    return bounds;
+}
+
+void DisplayListItem::addText(const CachedTextPtr &text,
+                              const QTransform &transform)
+{
+    myTexts.push_back(text);
+
+    const QRectF bounds = transform.mapRect(
+        QRectF(0, 0, text->getWidth(), text->getHeight()));
+    Command &command =
+        addCommand(CommandType::Text, static_cast<int>(myTexts.size() - 1),
+                   QPen(), QBrush(QColor(0, 0, 0, 0)), bounds);
+
+    command.myTransform = static_cast<int>(myTransforms.size());
+    myTransforms.push_back(transform);
+}
+
+void DisplayListItem::addLine(const QLineF &line, const QPen &pen)
+{
+    myLines.push_back(line);
+    addCommand(CommandType::Line, static_cast<int>(myLines.size() - 1), pen,
+               QBrush(),
+               getStrokeBounds(QRectF(line.p1(), line.p2()).normalized(), pen));
+}
+
+void DisplayListItem::addRect(const QRectF &rect, const QPen &pen,
+                              const QBrush &brush)
+{
+    myRects.push_back(rect);
+    addCommand(CommandType::Rect, static_cast<int>(myRects.size() - 1), pen,
+               brush, getStrokeBounds(rect, pen));
+}
+
+void DisplayListItem::addPath(const QPainterPath &path, const QPen &pen,
+                              const QBrush &brush)
+{
+    myPaths.push_back(path);
+    addCommand(CommandType::Path, static_cast<int>(myPaths.size() - 1), pen,
+               brush, getStrokeBounds(path.controlPointRect(), pen));
+}
+
+void DisplayListItem::addAntialiasedPath(const QPainterPath &path)
+{
+    addPath(path);
+    myCommands.back().myAntialiased = true;
+}
+
+void DisplayListItem::addPixmap(const QPixmap &pixmap, const QPointF &pos)
+{
+    myPixmaps.push_back(pixmap);
+    Command &command = addCommand(
+        CommandType::Pixmap, static_cast<int>(myPixmaps.size() - 1), QPen(),
+        QBrush(), QRectF(pos, QSizeF(pixmap.size())));
+    command.myOffset = pos;
+}
+
+void DisplayListItem::addRegion(const QRectF &bounds, const QString &toolTip,
+                                const std::function<void()> &callback)
+{
+    Region region;
+    region.myBounds = bounds;
+    region.myToolTip = toolTip;
+    region.myCallback = callback;
+
+    myBounds |= bounds;
+    myRegions.push_back(region);
+
+    setAcceptHoverEvents(true);
+    if (callback)
+        setAcceptedMouseButtons(Qt::AllButtons);
+}
+
+DisplayListItem::Command &DisplayListItem::addCommand(CommandType type,
+                                                      int data,
+                                                      const QPen &pen,
+                                                      const QBrush &brush,
+                                                      const QRectF &bounds)
+{
+    Command command;
+    command.myType = type;
+    command.myAntialiased = false;
+    command.myTransform = -1;
+    command.myPen = addPen(pen);
+    command.myBrush = addBrush(brush);
+    command.myData = data;
+
+    // Pad the bounds slightly, so that e.g. a horizontal line with a cosmetic
+    // pen does not have an empty bounding rectangle.
+    command.myBounds = bounds.adjusted(-1, -1, 1, 1);
+    myBounds |= command.myBounds;
+
+    myCommands.push_back(command);
+    return myCommands.back();
+}
+
+int DisplayListItem::addPen(const QPen &pen)
+{
+    if (myPens.size() < MAX_SHARED_PAINT_STATE)
+    {
+        auto it = std::find(myPens.begin(), myPens.end(), pen);
+        if (it != myPens.end())
+            return static_cast<int>(it - myPens.begin());
+    }
+
+    myPens.push_back(pen);
+    return static_cast<int>(myPens.size() - 1);
+}
+
+int DisplayListItem::addBrush(const QBrush &brush)
+{
+    if (myBrushes.size() < MAX_SHARED_PAINT_STATE)
+    {
+        auto it = std::find(myBrushes.begin(), myBrushes.end(), brush);
+        if (it != myBrushes.end())
+            return static_cast<int>(it - myBrushes.begin());
+    }
+
+    myBrushes.push_back(brush);
+    return static_cast<int>(myBrushes.size() - 1);
+}
+
+void DisplayListItem::finish()
+{
+    // The bounds changed while the commands were added.
+    prepareGeometryChange();
+
+    myRegionBuckets.clear();
+    if (myRegions.empty())
+        return;
+
+    const int num_buckets =
+        static_cast<int>(std::ceil(myBounds.width() / REGION_BUCKET_WIDTH)) +
+        1;
+    myRegionBuckets.resize(num_buckets);
+
+    auto getBucket = [&](double x) {
+        const int bucket = static_cast<int>(
+            std::floor((x - myBounds.left()) / REGION_BUCKET_WIDTH));
+        return std::max(0, std::min(bucket, num_buckets - 1));
+    };
+
+    for (int i = 0; i < static_cast<int>(myRegions.size()); ++i)
+    {
+        const QRectF &bounds = myRegions[i].myBounds;
+        const int last = getBucket(bounds.right());
+        for (int bucket = getBucket(bounds.left()); bucket <= last; ++bucket)
+            myRegionBuckets[bucket].push_back(i);
+    }
+}
+
+bool DisplayListItem::contains(const QPointF &point) const
+{
+    return findRegion(point) >= 0;
+}
+
+QPainterPath DisplayListItem::shape() const
+{
+    QPainterPath path;
+    path.setFillRule(Qt::WindingFill);
+    for (const Region &region : myRegions)
+        path.addRect(region.myBounds);
+
+    return path;
+}
+
+int DisplayListItem::findRegion(const QPointF &pos) const
+{
+    if (myRegionBuckets.empty() || !myBounds.contains(pos))
+        return -1;
+
+    const int bucket = std::min(
+        static_cast<int>((pos.x() - myBounds.left()) / REGION_BUCKET_WIDTH),
+        static_cast<int>(myRegionBuckets.size()) - 1);
+
+    // Regions that were added later are drawn on top.
+    const std::vector<int> &regions = myRegionBuckets[bucket];
+    for (auto it = regions.rbegin(); it != regions.rend(); ++it)
+    {
+        if (myRegions[*it].myBounds.contains(pos))
+            return *it;
+    }
+
+    return -1;
+}
+
+void DisplayListItem::paint(QPainter *painter,
+                            const QStyleOptionGraphicsItem *option, QWidget *)
+{
+    const QTransform base_transform = painter->worldTransform();
+    const bool antialiased = painter->testRenderHint(QPainter::Antialiasing);
+    const bool smooth_pixmaps =
+        painter->testRenderHint(QPainter::SmoothPixmapTransform);
+
+    for (const Command &command : myCommands)
+    {
+        if (!command.myBounds.intersects(option->exposedRect))
+            continue;
+
+        if (command.myTransform < 0)
+        {
+            painter->setWorldTransform(
+                QTransform::fromTranslate(command.myOffset.x(),
+                                          command.myOffset.y()) *
+                base_transform);
+        }
+        else
+        {
+            painter->setWorldTransform(myTransforms[command.myTransform] *
+                                       base_transform);
+        }
+
+        painter->setRenderHint(QPainter::Antialiasing,
+                               antialiased || command.myAntialiased);
+
+        const QPen &pen = myPens[command.myPen];
+        const QBrush &brush = myBrushes[command.myBrush];
+
+        switch (command.myType)
+        {
+            case CommandType::Text:
+                SimpleTextItem::draw(painter, *myTexts[command.myData], pen,
+                                     brush);
+                break;
+            case CommandType::Line:
+                painter->setPen(pen);
+                painter->drawLine(myLines[command.myData]);
+                break;
+            case CommandType::Rect:
+                painter->setPen(pen);
+                painter->setBrush(brush);
+                painter->drawRect(myRects[command.myData]);
+                break;
+            case CommandType::Path:
+                painter->setPen(pen);
+                painter->setBrush(brush);
+                painter->drawPath(myPaths[command.myData]);
+                break;
+            case CommandType::Pixmap:
+                // Match the default transformation mode of a
+                // QGraphicsPixmapItem.
+                painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+                painter->drawPixmap(QPointF(0, 0), myPixmaps[command.myData]);
+                painter->setRenderHint(QPainter::SmoothPixmapTransform,
+                                       smooth_pixmaps);
+                break;
+        }
+    }
+
+    painter->setWorldTransform(base_transform);
+    painter->setRenderHint(QPainter::Antialiasing, antialiased);
+}
+
+void DisplayListItem::hoverMoveEvent(QGraphicsSceneHoverEvent *event)
+{
+    setHoverRegion(findRegion(event->pos()));
+}
+
+void DisplayListItem::hoverLeaveEvent(QGraphicsSceneHoverEvent *)
+{
+    setHoverRegion(-1);
+}
+
+void DisplayListItem::setHoverRegion(int region)
+{
+    if (region == myHoverRegion)
+        return;
+
+    myHoverRegion = region;
+
+    if (region >= 0 && myRegions[region].myCallback)
+        setCursor(Qt::PointingHandCursor);
+    else
+        unsetCursor();
+
+    setToolTip(region >= 0 ? myRegions[region].myToolTip : QString());
+}
+
+void DisplayListItem::mousePressEvent(QGraphicsSceneMouseEvent *event)
+{
+    myPressedRegion = findRegion(event->pos());
+
+    // Let the items below handle the click (e.g. selecting notes in the
+    // staff) if there isn't anything to click on.
+    if (myPressedRegion < 0 || !myRegions[myPressedRegion].myCallback)
+    {
+        myPressedRegion = -1;
+        event->ignore();
+    }
+}
+
+void DisplayListItem::mouseReleaseEvent(QGraphicsSceneMouseEvent *)
+{
+    if (myPressedRegion < 0)
+        return;
+
+    // The callback may cause this item to be deleted, e.g. by redrawing the
+    // system.
+    const std::function<void()> callback =
+        myRegions[myPressedRegion].myCallback;
+    myPressedRegion = -1;
+    callback();
+}
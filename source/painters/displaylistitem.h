@@ -0,0 +1,161 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#ifndef PAINTERS_DISPLAYLISTITEM_H
+#define PAINTERS_DISPLAYLISTITEM_H
+
+#include <cstdint>
+#include <functional>
+#include <painters/textcache.h>
+#include <QBrush>
+#include <QGraphicsItem>
+#include <QLineF>
+#include <QPainterPath>
+#include <QPen>
+#include <QPixmap>
+#include <QTransform>
+#include <vector>
+
+/// Draws many simple symbols (text, lines, paths, etc) from a single item. A
+/// system of a large score can contain thousands of symbols, so this keeps
+/// the scene small and paints everything in one pass from a contiguous list
+/// of drawing commands. The commands are drawn in the order that they were
+/// added.
+/// Click and hover targets are found through a spatial index rather than by
+/// separate items.
+class DisplayListItem : public QGraphicsItem
+{
+public:
+    DisplayListItem();
+
+    /// Draws text with its top left corner at the given position, in the same
+    /// way as a SimpleTextItem.
+    /// @returns The area covered by the text.
+    QRectF addText(const CachedTextPtr &text, const QPointF &pos,
+                   const QPen &pen = QPen(),
+                   const QBrush &background = QBrush(QColor(0, 0, 0, 0)));
+
+    /// Draws text that is transformed from its default position, with the
+    /// top left corner at the origin.
+    void addText(const CachedTextPtr &text, const QTransform &transform);
+
+    void addLine(const QLineF &line, const QPen &pen = QPen());
+    void addRect(const QRectF &rect, const QPen &pen = QPen(),
+                 const QBrush &brush = QBrush());
+    void addPath(const QPainterPath &path, const QPen &pen = QPen(),
+                 const QBrush &brush = QBrush());
+
+    /// Draws a path with antialiasing enabled, like an AntialiasedPathItem.
+    void addAntialiasedPath(const QPainterPath &path);
+
+    /// Draws a pixmap with its top left corner at the given position.
+    void addPixmap(const QPixmap &pixmap, const QPointF &pos);
+
+    /// Adds an area that displays a tooltip when hovered over, and optionally
+    /// invokes a callback when clicked.
+    void addRegion(const QRectF &bounds, const QString &toolTip,
+                   const std::function<void()> &callback = nullptr);
+
+    /// Builds the index of the click and hover regions. This must be called
+    /// once all of the commands and regions have been added.
+    void finish();
+
+    virtual QRectF boundingRect() const override { return myBounds; }
+
+    /// Only the click and hover regions are part of the item, so that events
+    /// elsewhere reach the items underneath (e.g. barlines). This is checked
+    /// through the region index rather than the shape.
+    virtual bool contains(const QPointF &point) const override;
+
+    /// Returns the union of the regions. This is only built when needed
+    /// (e.g. for collision detection), since it is expensive to test against.
+    virtual QPainterPath shape() const override;
+
+    virtual void paint(QPainter *painter,
+                       const QStyleOptionGraphicsItem *option,
+                       QWidget *widget) override;
+
+protected:
+    virtual void hoverMoveEvent(QGraphicsSceneHoverEvent *event) override;
+    virtual void hoverLeaveEvent(QGraphicsSceneHoverEvent *event) override;
+    virtual void mousePressEvent(QGraphicsSceneMouseEvent *event) override;
+    virtual void mouseReleaseEvent(QGraphicsSceneMouseEvent *event) override;
+
+private:
+    enum class CommandType : uint8_t
+    {
+        Text,
+        Line,
+        Rect,
+        Path,
+        Pixmap
+    };
+
+    struct Command
+    {
+        CommandType myType;
+        bool myAntialiased;
+        /// Index into myTransforms, or -1 if the command is only translated
+        /// by myOffset.
+        int myTransform;
+        QPointF myOffset;
+        int myPen;
+        int myBrush;
+        /// Index into the list of texts, lines, etc for the command's type.
+        int myData;
+        /// The bounding rectangle of the command, in the item's coordinates.
+        QRectF myBounds;
+    };
+
+    /// An area that has a tooltip or that can be clicked.
+    struct Region
+    {
+        QRectF myBounds;
+        QString myToolTip;
+        std::function<void()> myCallback;
+    };
+
+    Command &addCommand(CommandType type, int data, const QPen &pen,
+                        const QBrush &brush, const QRectF &bounds);
+    int addPen(const QPen &pen);
+    int addBrush(const QBrush &brush);
+
+    /// Returns the topmost region containing the point, or -1.
+    int findRegion(const QPointF &pos) const;
+    void setHoverRegion(int region);
+
+    std::vector<Command> myCommands;
+    std::vector<QTransform> myTransforms;
+    std::vector<QPen> myPens;
+    std::vector<QBrush> myBrushes;
+
+    std::vector<CachedTextPtr> myTexts;
+    std::vector<QLineF> myLines;
+    std::vector<QRectF> myRects;
+    std::vector<QPainterPath> myPaths;
+    std::vector<QPixmap> myPixmaps;
+
+    std::vector<Region> myRegions;
+    /// The regions that overlap each vertical strip of the item.
+    std::vector<std::vector<int>> myRegionBuckets;
+    int myHoverRegion;
+    int myPressedRegion;
+
+    QRectF myBounds;
+};
+
+#endif
@@ -0,0 +1,126 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#include "layoutcache.h"
+
+#include <boost/functional/hash.hpp>
+#include <score/binaryserialization.h>
+#include <score/score.h>
+
+/// Returns the address of the first element of a range, which changes if the
+/// elements are moved to a different location.
+template <typename Range>
+static const void *getAddress(const Range &range)
+{
+    return range.empty() ? nullptr : &range.front();
+}
+
+LayoutCache::Key::Key() : myContentHash(0)
+{
+}
+
+bool LayoutCache::Key::operator==(const Key &other) const
+{
+    return myContentHash == other.myContentHash &&
+           myAddresses == other.myAddresses;
+}
+
+bool LayoutCache::Key::operator!=(const Key &other) const
+{
+    return !(*this == other);
+}
+
+LayoutCache::LayoutCache() : myNumHits(0), myNumLookups(0)
+{
+}
+
+LayoutCache::Key LayoutCache::computeKey(const Score &score,
+                                         const System &system, int systemIndex,
+                                         const std::vector<bool> &visibleStaves)
+{
+    Key key;
+    size_t &seed = key.myContentHash;
+    seed = ScoreUtils::hashContents(system);
+    boost::hash_combine(seed, score.getLineSpacing());
+
+    // The players' tunings are used for the standard notation, and the
+    // active players can be set in a previous system.
+    for (const Player &player : score.getPlayers())
+        boost::hash_combine(seed, ScoreUtils::hashContents(player));
+
+    const PlayerChange *players =
+        ScoreUtils::getCurrentPlayers(score, systemIndex, 0);
+    boost::hash_combine(seed,
+                        players ? ScoreUtils::hashContents(*players) : 0);
+
+    for (bool visible : visibleStaves)
+        boost::hash_combine(seed, visible);
+
+    // The addresses change if the notes, barlines, etc are moved (e.g. by
+    // inserting a system or undoing an edit).
+    std::vector<const void *> &addresses = key.myAddresses;
+    addresses.push_back(&system);
+    addresses.push_back(getAddress(system.getBarlines()));
+    for (const Staff &staff : system.getStaves())
+    {
+        addresses.push_back(&staff);
+
+        for (const Voice &voice : staff.getVoices())
+        {
+            addresses.push_back(getAddress(voice.getPositions()));
+
+            for (const Position &pos : voice.getPositions())
+                addresses.push_back(getAddress(pos.getNotes()));
+        }
+    }
+
+    return key;
+}
+
+bool LayoutCache::find(int systemIndex, const Key &key,
+                       SystemLayout &layout)
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+    ++myNumLookups;
+
+    auto it = myLayouts.find(systemIndex);
+    if (it == myLayouts.end() || it->second.first != key)
+        return false;
+
+    ++myNumHits;
+    layout = it->second.second;
+    return true;
+}
+
+void LayoutCache::insert(int systemIndex, const Key &key,
+                         const SystemLayout &layout)
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+    myLayouts[systemIndex] = std::make_pair(key, layout);
+}
+
+void LayoutCache::clear()
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+    myLayouts.clear();
+}
+
+std::pair<int, int> LayoutCache::getHitCount() const
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+    return std::make_pair(myNumHits, myNumLookups);
+}
@@ -0,0 +1,85 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#ifndef PAINTERS_LAYOUTCACHE_H
+#define PAINTERS_LAYOUTCACHE_H
+
+#include <map>
+#include <mutex>
+#include <painters/layoutinfo.h>
+#include <utility>
+#include <vector>
+
+class Score;
+class System;
+
+/// Caches the layout of each system, so that systems which have not changed
+/// can be redrawn without computing their layout again (e.g. when the whole
+/// score is redrawn, or when scrolling back to a system that was freed).
+/// Layouts are looked up by a key describing everything that they depend on,
+/// so the cache never needs to be invalidated. This can be shared between
+/// threads.
+class LayoutCache
+{
+public:
+    typedef std::vector<LayoutConstPtr> SystemLayout;
+
+    /// Identifies the inputs that a system's layout was computed from.
+    struct Key
+    {
+        Key();
+
+        bool operator==(const Key &other) const;
+        bool operator!=(const Key &other) const;
+
+        /// A hash of the contents of the system, the players' tunings, and
+        /// which staves are visible.
+        size_t myContentHash;
+        /// The layout refers to the notes, barlines, etc in the score, so it
+        /// can only be reused if they are at exactly the same addresses.
+        std::vector<const void *> myAddresses;
+    };
+
+    LayoutCache();
+
+    /// Computes the key for the system's layout.
+    static Key computeKey(const Score &score, const System &system,
+                          int systemIndex,
+                          const std::vector<bool> &visibleStaves);
+
+    /// Returns the cached layout for the system if it was computed with the
+    /// same key.
+    bool find(int systemIndex, const Key &key, SystemLayout &layout);
+
+    /// Stores the layout for the system, replacing any previous layout.
+    void insert(int systemIndex, const Key &key, const SystemLayout &layout);
+
+    /// Removes all cached layouts.
+    void clear();
+
+    /// Returns the number of lookups that were found in the cache, and the
+    /// total number of lookups.
+    std::pair<int, int> getHitCount() const;
+
+private:
+    mutable std::mutex myMutex;
+    std::map<int, std::pair<Key, SystemLayout>> myLayouts;
+    int myNumHits;
+    int myNumLookups;
+};
+
+#endif
@@ -21,28 +21,31 @@
 
 SimpleTextItem::SimpleTextItem(const QString &text, const QFont &font,
                                const QPen &pen, const QBrush &background)
-    : myText(text), myFont(font), myPen(pen), myBackground(background)
+    : myText(TextCache::get(font, text)), myPen(pen), myBackground(background)
 {
-    QFontMetricsF fm(myFont);
-    myAscent = fm.ascent();
-    myBoundingRect = QRectF(0, 0, fm.width(myText), fm.height());
 }
 
 void SimpleTextItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *,
                            QWidget *)
 {
+    draw(painter, *myText, myPen, myBackground);
+}
 
+void SimpleTextItem::draw(QPainter *painter, const CachedText &text,
+                          const QPen &pen, const QBrush &background)
+{
     // Draw the background rectangle. Avoid to cover other elements
     // by drawing only 1/3 of the rectangle, vertically centered.
     painter->fillRect(
-                myBoundingRect.x(),
-                myBoundingRect.y() + myBoundingRect.height() / 3,
-                myBoundingRect.width(),
-                myBoundingRect.height() / 3,
-                myBackground);
+                0,
+                text.getHeight() / 3,
+                text.getWidth(),
+                text.getHeight() / 3,
+                background);
 
-    painter->setPen(myPen);
-    painter->setFont(myFont);
-    // Match the way that QSimpleTextItem aligns text.
-    painter->drawText(0, myAscent, myText);
+    painter->setPen(pen);
+    painter->setFont(text.getFont());
+    // Match the way that QSimpleTextItem aligns text, with the top of the text
+    // at the item's origin.
+    painter->drawStaticText(QPointF(0, 0), text.getStaticText());
 }
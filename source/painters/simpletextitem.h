@@ -18,13 +18,15 @@
 #ifndef PAINTERS_SIMPLETEXTITEM_H
 #define PAINTERS_SIMPLETEXTITEM_H
 
+#include <painters/textcache.h>
 #include <QBrush>
 #include <QFont>
 #include <QGraphicsItem>
 #include <QPen>
 
 /// Replacement for QGraphicsSimpleTextItem, which is significantly faster but
-/// doesn't handle things like multi-line text.
+/// doesn't handle things like multi-line text. The text layout and metrics
+/// are shared with other items through the TextCache.
 class SimpleTextItem : public QGraphicsItem
 {
 public:
@@ -32,19 +34,24 @@ public:
                    const QPen &pen = QPen(),
                    const QBrush &background = QBrush(QColor(0,0,0,0)));
 
-    virtual QRectF boundingRect() const override { return myBoundingRect; }
+    virtual QRectF boundingRect() const override
+    {
+        return QRectF(0, 0, myText->getWidth(), myText->getHeight());
+    }
 
     virtual void paint(QPainter *painter,
                        const QStyleOptionGraphicsItem *option,
                        QWidget *widget) override;
 
+    /// Draws text in the same way as a SimpleTextItem, with the top left
+    /// corner of the text at the origin.
+    static void draw(QPainter *painter, const CachedText &text,
+                     const QPen &pen, const QBrush &background);
+
 private:
-    const QString myText;
-    const QFont myFont;
+    const CachedTextPtr myText;
     const QPen myPen;
     const QBrush myBackground;
-    QRectF myBoundingRect;
-    double myAscent;
 };
 
 #endif
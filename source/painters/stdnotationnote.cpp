@@ -21,7 +21,7 @@
 #include <numeric>
 #include <painters/layoutinfo.h>
 #include <painters/musicfont.h>
-#include <QFontMetricsF>
+#include <painters/textcache.h>
 #include <score/generalmidi.h>
 #include <score/score.h>
 #include <score/tuning.h>
@@ -96,8 +96,6 @@ void StdNotationNote::getNotesInStaff(
 
     QFont default_font(MusicFont::getFont(MusicFont::DEFAULT_FONT_SIZE));
     QFont grace_font(MusicFont::getFont(MusicFont::GRACE_NOTE_SIZE));
-    QFontMetricsF default_fm(default_font);
-    QFontMetricsF grace_fm(grace_font);
 
     int voiceIndex = 0;
     for (const Voice &voice : staff.getVoices())
@@ -194,9 +192,9 @@ void StdNotationNote::getNotesInStaff(
                         accidentals[y] = accidental;
                     }
 
-                    const QFontMetricsF *fm =
-                        stdNote.isGraceNote() ? &grace_fm : &default_fm;
-                    noteHeadWidth = fm->width(stdNote.getNoteHeadSymbol());
+                    noteHeadWidth = TextCache::getWidth(
+                        stdNote.isGraceNote() ? grace_font : default_font,
+                        stdNote.getNoteHeadSymbol());
                 }
 
                 const double x = layout.getPositionX(pos.getPosition()) +
@@ -0,0 +1,119 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "systemoffsets.h"
+
+#include <stdexcept>
+
+SystemOffsets::SystemOffsets(double spacing) : mySpacing(spacing)
+{
+}
+
+void SystemOffsets::reset(const std::vector<double> &heights)
+{
+    myHeights = heights;
+
+    // Build the tree in linear time.
+    const int n = static_cast<int>(myHeights.size());
+    myTree.assign(n + 1, 0.0);
+    for (int i = 1; i <= n; ++i)
+    {
+        myTree[i] += myHeights[i - 1] + mySpacing;
+
+        const int parent = i + (i & -i);
+        if (parent <= n)
+            myTree[parent] += myTree[i];
+    }
+}
+
+int SystemOffsets::getNumSystems() const
+{
+    return static_cast<int>(myHeights.size());
+}
+
+double SystemOffsets::getHeight(int system) const
+{
+    return myHeights.at(system);
+}
+
+void SystemOffsets::setHeight(int system, double height)
+{
+    const double delta = height - myHeights.at(system);
+    myHeights[system] = height;
+
+    const int n = getNumSystems();
+    for (int i = system + 1; i <= n; i += (i & -i))
+        myTree[i] += delta;
+}
+
+double SystemOffsets::getTop(int system) const
+{
+    if (system < 0 || system >= getNumSystems())
+        throw std::out_of_range("Invalid system index");
+
+    return getPrefixSum(system);
+}
+
+double SystemOffsets::getBottom(int system) const
+{
+    return getTop(system) + getHeight(system);
+}
+
+double SystemOffsets::getTotalHeight() const
+{
+    if (myHeights.empty())
+        return 0;
+
+    return getBottom(getNumSystems() - 1);
+}
+
+int SystemOffsets::findSystem(double y) const
+{
+    // Find the largest number of systems whose total height (including the
+    // spacing after each system) is less than y. The following system is
+    // then the first one that can reach y.
+    const int n = getNumSystems();
+    int mask = 1;
+    while (mask * 2 <= n)
+        mask *= 2;
+
+    int count = 0;
+    double sum = 0;
+    for (; mask > 0; mask /= 2)
+    {
+        const int next = count + mask;
+        if (next <= n && sum + myTree[next] < y)
+        {
+            count = next;
+            sum += myTree[next];
+        }
+    }
+
+    // The system may end before y, with y falling in the spacing after it.
+    if (count < n && sum + myHeights[count] < y)
+        ++count;
+
+    return count;
+}
+
+double SystemOffsets::getPrefixSum(int n) const
+{
+    double sum = 0;
+    for (int i = n; i > 0; i -= (i & -i))
+        sum += myTree[i];
+    return sum;
+}
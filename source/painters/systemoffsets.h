@@ -0,0 +1,62 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PAINTERS_SYSTEMOFFSETS_H
+#define PAINTERS_SYSTEMOFFSETS_H
+
+#include <vector>
+
+/// Tracks the vertical position of each system in the score, given the
+/// height of each system and a fixed spacing between systems. This is
+/// implemented as a Fenwick tree so that changing a system's height and
+/// looking up a system's position are both O(log n).
+class SystemOffsets
+{
+public:
+    explicit SystemOffsets(double spacing);
+
+    /// Replaces all of the system heights.
+    void reset(const std::vector<double> &heights);
+
+    int getNumSystems() const;
+
+    double getHeight(int system) const;
+    /// Updates the height of a system, which shifts all following systems.
+    void setHeight(int system, double height);
+
+    /// Returns the y-coordinate of the top of the system.
+    double getTop(int system) const;
+    /// Returns the y-coordinate of the bottom of the system.
+    double getBottom(int system) const;
+    /// Returns the height of the entire score.
+    double getTotalHeight() const;
+
+    /// Returns the index of the first system whose bottom is not above the
+    /// given y-coordinate, or getNumSystems() if there is no such system.
+    int findSystem(double y) const;
+
+private:
+    /// Returns the sum of the heights and spacing of the first n systems.
+    double getPrefixSum(int n) const;
+
+    double mySpacing;
+    std::vector<double> myHeights;
+    /// The Fenwick tree, which is indexed from 1.
+    std::vector<double> myTree;
+};
+
+#endif
@@ -24,18 +24,19 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/range/adaptor/map.hpp>
 #include <boost/range/algorithm/find_if.hpp>
-#include <painters/antialiasedpathitem.h>
 #include <painters/barlinepainter.h>
-#include <painters/clickablegroup.h>
+#include <painters/displaylistitem.h>
 #include <painters/keysignaturepainter.h>
+#include <painters/layoutcache.h>
 #include <painters/layoutinfo.h>
-#include <painters/simpletextitem.h>
 #include <painters/staffpainter.h>
 #include <painters/stdnotationnote.h>
+#include <painters/textcache.h>
 #include <painters/timesignaturepainter.h>
 #include <painters/verticallayout.h>
 #include <QBrush>
 #include <QDebug>
+#include <QFontMetricsF>
 #include <QGraphicsItem>
 #include <QPen>
 #include <score/score.h>
@@ -44,18 +45,15 @@
 #include <score/utils.h>
 #include <score/voiceutils.h>
 
-void SystemRenderer::centerHorizontally(QGraphicsItem &item, double xmin,
-                                        double xmax)
+double SystemRenderer::centerHorizontally(double width, double xmin,
+                                          double xmax)
 {
-    double itemWidth = item.boundingRect().width();
-    double centredX = xmin + ((xmax - (xmin + itemWidth)) / 2);
-    item.setX(centredX);
+    return xmin + ((xmax - (xmin + width)) / 2);
 }
 
-void SystemRenderer::centerSymbolVertically(QGraphicsItem &item, double y)
+double SystemRenderer::centerSymbolVertically(double height, double y)
 {
-    item.setY(y + 0.5 * (LayoutInfo::SYSTEM_SYMBOL_SPACING -
-                         item.boundingRect().height()));
+    return y + 0.5 * (LayoutInfo::SYSTEM_SYMBOL_SPACING - height);
 }
 
 SystemRenderer::SystemRenderer(const ScoreArea *score_area, const Score &score,
@@ -65,8 +63,9 @@ SystemRenderer::SystemRenderer(const ScoreArea *score_area, const Score &score,
       myViewOptions(view_options),
       myParentSystem(nullptr),
       myParentStaff(nullptr),
+      mySystemDisplayList(nullptr),
+      myStaffDisplayList(nullptr),
       myMusicNotationFont(MusicFont::getFont(MusicFont::DEFAULT_FONT_SIZE)),
-      myMusicFontMetrics(myMusicNotationFont),
       myPlainTextFont("Liberation Sans"),
       mySymbolTextFont("Liberation Sans"),
       myRehearsalSignFont("Helvetica")
@@ -77,32 +76,100 @@ SystemRenderer::SystemRenderer(const ScoreArea *score_area, const Score &score,
     myRehearsalSignFont.setPixelSize(12);
 }
 
+SystemRenderer::SystemLayout SystemRenderer::computeLayout(
+    const Score &score, const ViewOptions &view_options, const System &system,
+    int systemIndex, LayoutCache *cache)
+{
+    const ViewFilter *filter =
+        view_options.getFilter()
+            ? &score.getViewFilters()[*view_options.getFilter()]
+            : nullptr;
+
+    const int numStaves = static_cast<int>(system.getStaves().size());
+    std::vector<bool> visibleStaves;
+    for (int i = 0; i < numStaves; ++i)
+    {
+        visibleStaves.push_back(!filter ||
+                                filter->accept(score, systemIndex, i));
+    }
+
+    SystemLayout layouts;
+    LayoutCache::Key key;
+    if (cache)
+    {
+        key = LayoutCache::computeKey(score, system, systemIndex,
+                                      visibleStaves);
+        if (cache->find(systemIndex, key, layouts))
+            return layouts;
+    }
+
+    layouts.reserve(numStaves);
+
+    int i = 0;
+    for (const Staff &staff : system.getStaves())
+    {
+        if (!visibleStaves[i])
+            layouts.push_back(nullptr);
+        else
+        {
+            layouts.push_back(std::make_shared<LayoutInfo>(
+                score, system, systemIndex, staff, i));
+        }
+
+        ++i;
+    }
+
+    if (cache)
+        cache->insert(systemIndex, key, layouts);
+
+    return layouts;
+}
+
+double SystemRenderer::getHeight(const SystemLayout &layouts)
+{
+    double height = 0;
+    for (const LayoutConstPtr &layout : layouts)
+    {
+        if (!layout)
+            continue;
+
+        if (height == 0)
+            height += layout->getSystemSymbolSpacing();
+
+        height += layout->getStaffHeight();
+    }
+
+    return height;
+}
+
 QGraphicsItem *SystemRenderer::operator()(const System &system,
                                           int systemIndex)
+{
+    return (*this)(system, systemIndex,
+                   computeLayout(myScore, myViewOptions, system, systemIndex));
+}
+
+QGraphicsItem *SystemRenderer::operator()(const System &system,
+                                          int systemIndex,
+                                          const SystemLayout &layouts)
 {
     // Draw the bounding rectangle for the system.
     myParentSystem = new QGraphicsRectItem();
     myParentSystem->setPen(QPen(QBrush(QColor(0, 0, 0, 127)), 0.5));
 
-    const ViewFilter *filter =
-        myViewOptions.getFilter()
-            ? &myScore.getViewFilters()[*myViewOptions.getFilter()]
-            : nullptr;
-
     // Draw each staff.
     double height = 0;
     int i = 0;
     for (const Staff &staff : system.getStaves())
     {
-        if (filter && !filter->accept(myScore, systemIndex, i))
+        const LayoutConstPtr &layout = layouts[i];
+        if (!layout)
         {
             ++i;
             continue;
         }
 
         const bool isFirstStaff = (height == 0);
-        LayoutConstPtr layout = std::make_shared<LayoutInfo>(
-            myScore, system, systemIndex, staff, i);
 
         if (isFirstStaff)
         {
@@ -114,7 +181,7 @@ QGraphicsItem *SystemRenderer::operator()(const System &system,
                                          ScoreLocation(myScore, systemIndex, i),
                                          myScoreArea->getClickPubSub());
         myParentStaff->setPos(0, height);
-        myParentStaff->setParentItem(myParentSystem);
+        addItem(myParentStaff, myParentSystem);
         height += layout->getStaffHeight();
 
         if (isFirstStaff)
@@ -125,18 +192,19 @@ QGraphicsItem *SystemRenderer::operator()(const System &system,
             (staff.getClefType() == Staff::TrebleClef) ? -6 : -21;
         auto pubsub = myScoreArea->getClickPubSub();
         const ScoreLocation location(myScore, systemIndex, i);
-        auto clef = new SimpleTextItem(staff.getClefType() == Staff::TrebleClef
-                                           ? QChar(MusicFont::TrebleClef)
-                                           : QChar(MusicFont::BassClef),
-                                       myMusicNotationFont);
-        auto group = new ClickableGroup(
-            QObject::tr("Click to change clef type."), [=]() {
+        const QChar clef = (staff.getClefType() == Staff::TrebleClef)
+                               ? QChar(MusicFont::TrebleClef)
+                               : QChar(MusicFont::BassClef);
+
+        DisplayListItem &displayList = getDisplayList(myParentStaff);
+        const QRectF clefBounds = displayList.addText(
+            TextCache::get(myMusicNotationFont, clef),
+            QPointF(LayoutInfo::CLEF_PADDING,
+                    layout->getTopStdNotationLine() + CLEF_OFFSET));
+        displayList.addRegion(clefBounds,
+                              QObject::tr("Click to change clef type."), [=]() {
             pubsub->publish(ClickType::Clef, location);
         });
-        group->addToGroup(clef);
-        group->setPos(LayoutInfo::CLEF_PADDING,
-                      layout->getTopStdNotationLine() + CLEF_OFFSET);
-        group->setParentItem(myParentStaff);
 
         drawTabClef(LayoutInfo::CLEF_PADDING, *layout, location);
 
@@ -153,13 +221,50 @@ QGraphicsItem *SystemRenderer::operator()(const System &system,
         drawPlayerChanges(system, i, *layout);
         drawStdNotation(system, staff, *layout);
 
+        finishDisplayList(myStaffDisplayList);
         ++i;
     }
 
+    finishDisplayList(mySystemDisplayList);
+
     myParentSystem->setRect(0, 0, LayoutInfo::STAFF_WIDTH, height);
     return myParentSystem;
 }
 
+DisplayListItem &SystemRenderer::getDisplayList(QGraphicsItem *parent)
+{
+    Q_ASSERT(parent == myParentSystem || parent == myParentStaff);
+    DisplayListItem *&displayList = (parent == myParentSystem)
+                                        ? mySystemDisplayList
+                                        : myStaffDisplayList;
+
+    if (!displayList)
+    {
+        displayList = new DisplayListItem();
+        displayList->setParentItem(parent);
+    }
+
+    return *displayList;
+}
+
+void SystemRenderer::addItem(QGraphicsItem *item, QGraphicsItem *parent)
+{
+    Q_ASSERT(parent == myParentSystem || parent == myParentStaff);
+    finishDisplayList(parent == myParentSystem ? mySystemDisplayList
+                                               : myStaffDisplayList);
+
+    item->setParentItem(parent);
+}
+
+void SystemRenderer::finishDisplayList(DisplayListItem *&displayList)
+{
+    if (displayList)
+    {
+        displayList->finish();
+        displayList = nullptr;
+    }
+}
+
 void SystemRenderer::drawTabClef(double x, const LayoutInfo &layout,
                                  const ScoreLocation &location)
 {
@@ -169,33 +274,29 @@ void SystemRenderer::drawTabClef(double x, const LayoutInfo &layout,
         (layout.getStringCount() - 1) * layout.getTabLineSpacing() * 0.6;
     QFont font = MusicFont::getFont(pixel_size);
 
-    auto clef = new SimpleTextItem(QChar(MusicFont::TabClef), font);
+    DisplayListItem &displayList = getDisplayList(myParentStaff);
+    const QRectF bounds = displayList.addText(
+        TextCache::get(font, QChar(MusicFont::TabClef)),
+        QPointF(x, layout.getTopTabLine() - pixel_size / 2.1));
 
     auto pubsub = myScoreArea->getClickPubSub();
-    auto group = new ClickableGroup(
-        QObject::tr("Click to edit the number of strings."), [=]() {
+    displayList.addRegion(
+        bounds, QObject::tr("Click to edit the number of strings."), [=]() {
         pubsub->publish(ClickType::TabClef, location);
     });
-    group->addToGroup(clef);
-
-    // Position the clef symbol.
-    group->setPos(x, layout.getTopTabLine() - pixel_size / 2.1);
-    group->setParentItem(myParentStaff);
 }
 
 void SystemRenderer::drawBarNumber(int systemIndex, const LayoutInfo &layout)
 {
-    int number = 1;
-    for (int i = 0; i < systemIndex; ++i)
-    {
-        const System &system = myScore.getSystems()[i];
-        number += static_cast<int>(system.getBarlines().size()) - 1;
-    }
-
-    auto text = new SimpleTextItem(QString::number(number), myPlainTextFont);
-    text->setPos(-text->boundingRect().width() - LayoutInfo::BAR_NUMBER_PADDING,
-                 layout.getTopStdNotationLine());
-    text->setParentItem(myParentStaff);
+    const int number =
+        myScore.getBarNumberIndex().getFirstBarNumber(systemIndex);
+
+    const CachedTextPtr text =
+        TextCache::get(myPlainTextFont, QString::number(number));
+    getDisplayList(myParentStaff)
+        .addText(text,
+                 QPointF(-text->getWidth() - LayoutInfo::BAR_NUMBER_PADDING,
+                         layout.getTopStdNotationLine()));
 }
 
 void SystemRenderer::drawBarlines(const System &system, int systemIndex,
@@ -252,7 +353,7 @@ void SystemRenderer::drawBarlines(const System &system, int systemIndex,
         }
 
         barlinePainter->setPos(x, 0);
-        barlinePainter->setParentItem(myParentStaff);
+        addItem(barlinePainter, myParentStaff);
 
         if (keySig.isVisible())
         {
@@ -261,7 +362,7 @@ void SystemRenderer::drawBarlines(const System &system, int systemIndex,
                         myScoreArea->getClickPubSub());
 
             keySigPainter->setPos(keySigX, layout->getTopStdNotationLine());
-            keySigPainter->setParentItem(myParentStaff);
+            addItem(keySigPainter, myParentStaff);
         }
 
         if (timeSig.isVisible())
@@ -271,7 +372,7 @@ void SystemRenderer::drawBarlines(const System &system, int systemIndex,
                         myScoreArea->getClickPubSub());
 
             timeSigPainter->setPos(timeSigX, layout->getTopStdNotationLine());
-            timeSigPainter->setParentItem(myParentStaff);
+            addItem(timeSigPainter, myParentStaff);
         }
 
         if (barline.hasRehearsalSign() && isFirstStaff)
@@ -279,39 +380,49 @@ void SystemRenderer::drawBarlines(const System &system, int systemIndex,
             const RehearsalSign &sign = barline.getRehearsalSign();
             const int RECTANGLE_OFFSET = 4;
 
-            auto signLetters = new SimpleTextItem(
-                QString::fromStdString(sign.getLetters()), myRehearsalSignFont);
-            signLetters->setX(rehearsalSignX + RECTANGLE_OFFSET);
-            centerSymbolVertically(*signLetters, 0);
+            const CachedTextPtr signLetters = TextCache::get(
+                myRehearsalSignFont, QString::fromStdString(sign.getLetters()));
+            const QPointF signLettersPos(
+                rehearsalSignX + RECTANGLE_OFFSET,
+                centerSymbolVertically(signLetters->getHeight(), 0));
 
             QFontMetricsF metrics(myRehearsalSignFont);
             const Barline *nextBar = system.getNextBarline(barline.getPosition());
             Q_ASSERT(nextBar);
             const double signTextX =
-                signLetters->x() + signLetters->boundingRect().width() + 7;
+                signLettersPos.x() + signLetters->getWidth() + 7;
             // If the description is too wide, cut it off with an ellipsis.
             QString shortenedSignText = metrics.elidedText(
                 QString::fromStdString(sign.getDescription()), Qt::ElideRight,
                 layout->getPositionX(nextBar->getPosition()) - signTextX -
                     RECTANGLE_OFFSET);
 
-            auto signText =
-                new SimpleTextItem(shortenedSignText, myRehearsalSignFont);
-            signText->setX(signTextX);
-            centerSymbolVertically(*signText, 0);
+            const CachedTextPtr signText =
+                TextCache::get(myRehearsalSignFont, shortenedSignText);
+
+            // Draw rectangle around rehearsal sign letters. It is centered
+            // including the width of its outline.
+            const QPen rectPen;
+            const QSizeF rectSize(signLetters->getWidth() + 7,
+                                  signLetters->getHeight());
+            const QRectF rect(
+                QPointF(rehearsalSignX,
+                        centerSymbolVertically(
+                            rectSize.height() + rectPen.widthF(), 0) +
+                            0.5 * rectPen.widthF()),
+                rectSize);
+
+            DisplayListItem &displayList = getDisplayList(myParentSystem);
+            displayList.addRect(rect, rectPen);
+            const QRectF signTextBounds = displayList.addText(
+                signText,
+                QPointF(signTextX,
+                        centerSymbolVertically(signText->getHeight(), 0)));
+            displayList.addText(signLetters, signLettersPos);
+
             // The tooltip should contain the full description.
-            signText->setToolTip(QString::fromStdString(sign.getDescription()));
-
-            // Draw rectangle around rehearsal sign letters.
-            QRectF boundingRect = signLetters->boundingRect();
-            boundingRect.setWidth(boundingRect.width() + 7);
-            auto rect = new QGraphicsRectItem(boundingRect);
-            rect->setX(rehearsalSignX);
-            centerSymbolVertically(*rect, 0);
-
-            rect->setParentItem(myParentSystem);
-            signText->setParentItem(myParentSystem);
-            signLetters->setParentItem(myParentSystem);
+            displayList.addRegion(
+                signTextBounds, QString::fromStdString(sign.getDescription()));
         }
     }
 }
@@ -319,6 +430,12 @@ void SystemRenderer::drawBarlines(const System &system, int systemIndex,
 void SystemRenderer::drawTabNotes(const Staff &staff,
                                   const LayoutConstPtr &layout)
 {
+    // Share the same paint state between all of the tab notes.
+    const QPen note_pen(Qt::black);
+    const QPen tied_note_pen(Qt::lightGray);
+    const QBrush background(QColor(255, 255, 255));
+    DisplayListItem &displayList = getDisplayList(myParentStaff);
+
     for (const Voice &voice : staff.getVoices())
     {
         for (const Position &pos : voice.getPositions())
@@ -333,17 +450,18 @@ void SystemRenderer::drawTabNotes(const Staff &staff,
                 const QString text = QString::fromStdString(
                             boost::lexical_cast<std::string>(note));
 
-                auto tabNote = new SimpleTextItem(
-                    text, myPlainTextFont,
-                    QPen(note.hasProperty(Note::Tied) ? Qt::lightGray
-                                                      : Qt::black),
-                    QBrush(QColor(255, 255, 255)));
-
-                centerHorizontally(*tabNote, location,
-                                   location + layout->getPositionSpacing());
-                tabNote->setY(layout->getTabLine(note.getString() + 1) -
-                              0.6 * myPlainTextFont.pixelSize());
-                tabNote->setParentItem(myParentStaff);
+                const CachedTextPtr tabNote =
+                    TextCache::get(myPlainTextFont, text);
+
+                displayList.addText(
+                    tabNote,
+                    QPointF(centerHorizontally(
+                                tabNote->getWidth(), location,
+                                location + layout->getPositionSpacing()),
+                            layout->getTabLine(note.getString() + 1) -
+                                0.6 * myPlainTextFont.pixelSize()),
+                    note.hasProperty(Note::Tied) ? tied_note_pen : note_pen,
+                    background);
             }
 
             // Draw arpeggios if necessary.
@@ -370,23 +488,27 @@ void SystemRenderer::drawArpeggio(const Position &position, double x,
     // Take a vibrato segment, spanning the distance from top to bottom note,
     // and then rotate it by 90 degrees.
     const QChar arpeggioSymbol = MusicFont::Vibrato;
-    const double symbolWidth = myMusicFontMetrics.width(arpeggioSymbol);
+    const double symbolWidth =
+        TextCache::getWidth(myMusicNotationFont, arpeggioSymbol);
     const int numSymbols = height / symbolWidth;
 
-    auto arpeggio = new SimpleTextItem(QString(numSymbols, arpeggioSymbol),
-                                       myMusicNotationFont);
-    arpeggio->setPos(x + arpeggio->boundingRect().height() / 2.0 - 3.0, top);
-    arpeggio->setRotation(90);
-    arpeggio->setParentItem(myParentStaff);
+    DisplayListItem &displayList = getDisplayList(myParentStaff);
+
+    const CachedTextPtr arpeggio = TextCache::get(
+        myMusicNotationFont, QString(numSymbols, arpeggioSymbol));
+    displayList.addText(
+        arpeggio, QTransform().rotate(90) *
+                      QTransform::fromTranslate(
+                          x + arpeggio->getHeight() / 2.0 - 3.0, top));
 
     // Draw the end of the arpeggio.
     const QChar arpeggioEnd = position.hasProperty(Position::ArpeggioUp) ?
                 MusicFont::ArpeggioUp : MusicFont::ArpeggioDown;
 
-    auto endPoint = new SimpleTextItem(arpeggioEnd, myMusicNotationFont);
     const double y = position.hasProperty(Position::ArpeggioUp) ? top : bottom;
-    endPoint->setPos(x, y - 1.45 * myMusicNotationFont.pixelSize());
-    endPoint->setParentItem(myParentStaff);
+    displayList.addText(
+        TextCache::get(myMusicNotationFont, arpeggioEnd),
+        QPointF(x, y - 1.45 * myMusicNotationFont.pixelSize()));
 }
 
 void SystemRenderer::drawSystemSymbols(const System &system,
@@ -443,12 +565,9 @@ void SystemRenderer::drawSystemSymbols(const System &system,
 
 void SystemRenderer::drawDividerLine(double y)
 {
-    auto line = new QGraphicsLineItem();
-    line->setLine(0, y, LayoutInfo::STAFF_WIDTH, y);
-    line->setOpacity(0.5);
-    line->setPen(QPen(Qt::black, 0.5, Qt::DashLine));
-
-    line->setParentItem(myParentSystem);
+    getDisplayList(myParentSystem)
+        .addLine(QLineF(0, y, LayoutInfo::STAFF_WIDTH, y),
+                 QPen(QColor(0, 0, 0, 127), 0.5, Qt::DashLine));
 }
 
 void SystemRenderer::drawAlternateEndings(const System &system,
@@ -457,6 +576,7 @@ void SystemRenderer::drawAlternateEndings(const System &system,
 {
     const double TOP_LINE_OFFSET = 2;
     const double TEXT_PADDING = 5;
+    DisplayListItem &displayList = getDisplayList(myParentSystem);
 
     for (const AlternateEnding &ending : system.getAlternateEndings())
     {
@@ -464,18 +584,16 @@ void SystemRenderer::drawAlternateEndings(const System &system,
                                 0.5 * layout.getPositionSpacing();
 
         // Draw the vertical line.
-        auto vertLine = new QGraphicsLineItem();
-        vertLine->setLine(0, TOP_LINE_OFFSET, 0,
-                          LayoutInfo::SYSTEM_SYMBOL_SPACING - TOP_LINE_OFFSET);
-        vertLine->setPos(location, height);
-        vertLine->setParentItem(myParentSystem);
+        displayList.addLine(QLineF(
+            location, height + TOP_LINE_OFFSET, location,
+            height + LayoutInfo::SYSTEM_SYMBOL_SPACING - TOP_LINE_OFFSET));
 
         // Draw the text indicating the repeat numbers.
-        auto text = new SimpleTextItem(
-            QString::fromStdString(boost::lexical_cast<std::string>(ending)),
-            myPlainTextFont);
-        text->setPos(location + TEXT_PADDING, height + TEXT_PADDING / 2.0);
-        text->setParentItem(myParentSystem);
+        displayList.addText(
+            TextCache::get(myPlainTextFont,
+                           QString::fromStdString(
+                               boost::lexical_cast<std::string>(ending))),
+            QPointF(location + TEXT_PADDING, height + TEXT_PADDING / 2.0));
 
         // The horizontal line either stretches to the next repeat end bar
         // in the system, or just to the next bar.
@@ -503,10 +621,8 @@ void SystemRenderer::drawAlternateEndings(const System &system,
         // Ensure that the line doesn't extend past the edge of the system.
         endX = boost::algorithm::clamp(endX, 0.0, LayoutInfo::STAFF_WIDTH);
 
-        auto horizLine = new QGraphicsLineItem();
-        horizLine->setLine(0, TOP_LINE_OFFSET, endX - location, TOP_LINE_OFFSET);
-        horizLine->setPos(location, height);
-        horizLine->setParentItem(myParentSystem);
+        displayList.addLine(QLineF(location, height + TOP_LINE_OFFSET, endX,
+                                   height + TOP_LINE_OFFSET));
     }
 }
 
@@ -573,21 +689,16 @@ void SystemRenderer::drawTempoMarkers(const System &system,
                                       const LayoutInfo &layout,
                                       double height)
 {
+    DisplayListItem &displayList = getDisplayList(myParentSystem);
+
     for (const TempoMarker &tempo : system.getTempoMarkers())
     {
         if (tempo.getMarkerType() == TempoMarker::NotShown)
             continue;
 
+        // TODO - allow editing a tempo marker by clicking on it.
         const double x = layout.getPositionX(tempo.getPosition());
 
-#if 0
-        auto group = new ClickableGroup([]() {
-            // TODO - allow editing a tempo marker by clicking on it.
-        });
-#else
-        auto group = new QGraphicsItemGroup();
-#endif
-
         QFont font = myPlainTextFont;
         if (tempo.getMarkerType() == TempoMarker::AlterationOfPace)
             font.setItalic(true);
@@ -609,14 +720,14 @@ void SystemRenderer::drawTempoMarkers(const System &system,
             const double NOTE_HEIGHT = 16;
 
             // Add the beat type image.
-            QFontMetricsF fm(font);
             QPixmap image(getBeatTypeImage(tempo.getBeatType()));
-            auto pixmap = new QGraphicsPixmapItem(image.scaled(
-                fm.width(imageSpacing), NOTE_HEIGHT,
-                Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
-            pixmap->setX(fm.width(text));
-            centerSymbolVertically(*pixmap, height);
-            group->addToGroup(pixmap);
+            const QPixmap pixmap = image.scaled(
+                TextCache::getWidth(font, imageSpacing), NOTE_HEIGHT,
+                Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+            displayList.addPixmap(
+                pixmap,
+                QPointF(x + TextCache::getWidth(font, text),
+                        centerSymbolVertically(pixmap.height(), height)));
 
             text += imageSpacing;
             text += " = ";
@@ -625,12 +736,13 @@ void SystemRenderer::drawTempoMarkers(const System &system,
             {
                 // Add the second beat type image.
                 QPixmap image(getBeatTypeImage(tempo.getListessoBeatType()));
-                auto pixmap = new QGraphicsPixmapItem(image.scaled(
-                    fm.width(imageSpacing), NOTE_HEIGHT,
-                    Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
-                pixmap->setX(fm.width(text));
-                centerSymbolVertically(*pixmap, height);
-                group->addToGroup(pixmap);
+                const QPixmap pixmap = image.scaled(
+                    TextCache::getWidth(font, imageSpacing), NOTE_HEIGHT,
+                    Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+                displayList.addPixmap(
+                    pixmap,
+                    QPointF(x + TextCache::getWidth(font, text),
+                            centerSymbolVertically(pixmap.height(), height)));
 
                 text += imageSpacing;
             }
@@ -644,40 +756,41 @@ void SystemRenderer::drawTempoMarkers(const System &system,
 
                 const QString imageSpacing(12, ' ');
                 QPixmap image(getTripletFeelImage(tempo));
-                pixmap = new QGraphicsPixmapItem(image.scaled(
-                    fm.width(imageSpacing), 21,
-                    Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
-                pixmap->setX(fm.width(text));
-                centerSymbolVertically(*pixmap, height);
-                group->addToGroup(pixmap);
+                const QPixmap pixmap = image.scaled(
+                    TextCache::getWidth(font, imageSpacing), 21,
+                    Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+                displayList.addPixmap(
+                    pixmap,
+                    QPointF(x + TextCache::getWidth(font, text),
+                            centerSymbolVertically(pixmap.height(), height)));
 
                 text += imageSpacing + " )";
             }
         }
 
-        auto textItem = new SimpleTextItem(text, font);
-        centerSymbolVertically(*textItem, height);
-        group->addToGroup(textItem);
-
-        group->setX(x);
-        group->setParentItem(myParentSystem);
+        const CachedTextPtr textItem = TextCache::get(font, text);
+        displayList.addText(
+            textItem,
+            QPointF(x, centerSymbolVertically(textItem->getHeight(), height)));
     }
 }
 
 void SystemRenderer::drawChordText(const System &system,
                                    const LayoutInfo &layout, double height)
 {
+    DisplayListItem &displayList = getDisplayList(myParentSystem);
+
     for (const ChordText &chord : system.getChords())
     {
         const double x = layout.getPositionX(chord.getPosition());
         const std::string text =
             boost::lexical_cast<std::string>(chord.getChordName());
 
-        auto textItem =
-            new SimpleTextItem(QString::fromStdString(text), myPlainTextFont);
-        textItem->setX(x);
-        centerSymbolVertically(*textItem, height);
-        textItem->setParentItem(myParentSystem);
+        const CachedTextPtr textItem =
+            TextCache::get(myPlainTextFont, QString::fromStdString(text));
+        displayList.addText(
+            textItem,
+            QPointF(x, centerSymbolVertically(textItem->getHeight(), height)));
     }
 }
 
@@ -694,9 +807,10 @@ void SystemRenderer::drawTextItems(const System &system,
         text_item->setFont(myPlainTextFont);
         text_item->setText(contents);
 
-        text_item->setX(layout.getPositionX(text.getPosition()));
-        centerSymbolVertically(*text_item, height);
-        text_item->setParentItem(myParentSystem);
+        text_item->setPos(layout.getPositionX(text.getPosition()),
+                          centerSymbolVertically(
+                              text_item->boundingRect().height(), height));
+        addItem(text_item, myParentSystem);
     }
 }
 
@@ -746,6 +860,8 @@ void SystemRenderer::drawRhythmSlashes()
 
 void SystemRenderer::drawLegato(const Staff &staff, const LayoutInfo &layout)
 {
+    DisplayListItem &displayList = getDisplayList(myParentStaff);
+
     for (const Voice &voice : staff.getVoices())
     {
         std::map<int, int> arcs;
@@ -788,9 +904,8 @@ void SystemRenderer::drawLegato(const Staff &staff, const LayoutInfo &layout)
                     path.moveTo(width, height / 2);
                     path.arcTo(0, 0, width, height, 0, 180);
 
-                    auto arc = new AntialiasedPathItem(path);
-                    arc->setPos(left + layout.getPositionSpacing() / 2, y);
-                    arc->setParentItem(myParentStaff);
+                    displayList.addAntialiasedPath(path.translated(
+                        left + layout.getPositionSpacing() / 2, y));
 
                     arcs.erase(arcs.find(string));
                 }
@@ -806,10 +921,9 @@ void SystemRenderer::drawLegato(const Staff &staff, const LayoutInfo &layout)
                     path.moveTo(width, height / 2);
                     path.arcTo(0, 0, width, height, 0, 180);
 
-                    auto arc = new AntialiasedPathItem(path);
-                    arc->setPos(layout.getPositionX(position) + 2,
-                                layout.getTabLine(string) - 2);
-                    arc->setParentItem(myParentStaff);
+                    displayList.addAntialiasedPath(
+                        path.translated(layout.getPositionX(position) + 2,
+                                        layout.getTabLine(string) - 2));
 
                     if (arcs.find(string) != arcs.end())
                         arcs.erase(arcs.find(string));
@@ -843,12 +957,12 @@ void SystemRenderer::drawPlayerChanges(const System &system, int staffIndex,
         else
             description = "(No Players)";
 
-        auto text = new SimpleTextItem(description, myPlainTextFont);
-        text->setPos(layout.getPositionX(change.getPosition()),
-                     layout.getBottomStdNotationLine() +
-                     LayoutInfo::STAFF_BORDER_SPACING +
-                     layout.getStdNotationStaffBelowSpacing());
-        text->setParentItem(myParentStaff);
+        getDisplayList(myParentStaff)
+            .addText(TextCache::get(myPlainTextFont, description),
+                     QPointF(layout.getPositionX(change.getPosition()),
+                             layout.getBottomStdNotationLine() +
+                                 LayoutInfo::STAFF_BORDER_SPACING +
+                                 layout.getStdNotationStaffBelowSpacing()));
     }
 }
 
@@ -905,7 +1019,7 @@ void SystemRenderer::drawSlides(const Staff &staff, const LayoutInfo &layout)
 }
 
 void SystemRenderer::drawSlide(const LayoutInfo &layout, int string,
-                               bool slideUp, int position1, int position2) const
+                               bool slideUp, int position1, int position2)
 {
     Q_ASSERT(position1 <= position2);
 
@@ -934,37 +1048,43 @@ void SystemRenderer::drawSlide(const LayoutInfo &layout, int string,
     path.moveTo(0, 0);
     path.lineTo(width - layout.getPositionSpacing() / 2, height);
 
-    auto slide = new AntialiasedPathItem(path);
-    slide->setPos(left + layout.getPositionSpacing() / 1.5 + 1,
-                  y + height / 2);
-    slide->setParentItem(myParentStaff);
+    getDisplayList(myParentStaff)
+        .addAntialiasedPath(path.translated(
+            left + layout.getPositionSpacing() / 1.5 + 1, y + height / 2));
 }
 
 void SystemRenderer::drawSymbolsBelowTabStaff(const LayoutInfo &layout)
 {
+    DisplayListItem &displayList = getDisplayList(myParentStaff);
+
     for (const SymbolGroup &symbolGroup : layout.getTabStaffBelowSymbols())
     {
-        QGraphicsItem *renderedSymbol = nullptr;
+        CachedTextPtr text;
+        // Offset of the text from its default location.
+        QPointF offset(0, -8);
 
         switch (symbolGroup.getSymbolType())
         {
         case SymbolGroup::PickStrokeUp:
-            renderedSymbol = createPickStroke(QChar(MusicFont::PickStrokeUp));
-            break;
         case SymbolGroup::PickStrokeDown:
-            renderedSymbol = createPickStroke(QChar(MusicFont::PickStrokeDown));
+            text = TextCache::get(
+                myMusicNotationFont,
+                QChar(symbolGroup.getSymbolType() == SymbolGroup::PickStrokeUp
+                          ? MusicFont::PickStrokeUp
+                          : MusicFont::PickStrokeDown));
+            offset = QPointF(2, 2 - TextCache::getAscent(myMusicNotationFont));
             break;
         case SymbolGroup::Tap:
-            renderedSymbol = createPlainTextSymbol("T", QFont::StyleNormal);
+            text = getPlainTextSymbol("T", QFont::StyleNormal);
             break;
         case SymbolGroup::Hammeron:
-            renderedSymbol = createPlainTextSymbol("H", QFont::StyleNormal);
+            text = getPlainTextSymbol("H", QFont::StyleNormal);
             break;
         case SymbolGroup::Pulloff:
-            renderedSymbol = createPlainTextSymbol("P", QFont::StyleNormal);
+            text = getPlainTextSymbol("P", QFont::StyleNormal);
             break;
         case SymbolGroup::Slide:
-            renderedSymbol = createPlainTextSymbol("sl.", QFont::StyleItalic);
+            text = getPlainTextSymbol("sl.", QFont::StyleItalic);
             break;
         case SymbolGroup::ArtificialHarmonic:
         {
@@ -972,12 +1092,13 @@ void SystemRenderer::drawSymbolsBelowTabStaff(const LayoutInfo &layout)
                 symbolGroup.getVoice().getPositions(),
                 symbolGroup.getLeftPosition());
             Q_ASSERT(pos);
-            renderedSymbol = createArtificialHarmonicText(*pos);
+            text = getPlainTextSymbol(getArtificialHarmonicText(*pos),
+                                      QFont::StyleNormal);
             break;
         }
         default:
             Q_ASSERT(false);
-            break;
+            continue;
         }
 
         double x = layout.getPositionX(symbolGroup.getLeftPosition());
@@ -989,46 +1110,27 @@ void SystemRenderer::drawSymbolsBelowTabStaff(const LayoutInfo &layout)
             x += 0.5 * (layout.getPositionX(symbolGroup.getRightPosition()) - x);
         }
 
-        centerHorizontally(*renderedSymbol, x, x + symbolGroup.getWidth());
-        renderedSymbol->setY(layout.getBottomTabLine() +
-                             symbolGroup.getHeight() *
-                                 LayoutInfo::TAB_SYMBOL_SPACING);
-
-        renderedSymbol->setParentItem(myParentStaff);
+        const QPointF pos(
+            centerHorizontally(text->getWidth(), x, x + symbolGroup.getWidth()),
+            layout.getBottomTabLine() +
+                symbolGroup.getHeight() * LayoutInfo::TAB_SYMBOL_SPACING);
+        displayList.addText(text, pos + offset);
     }
 }
 
-QGraphicsItem *SystemRenderer::createPickStroke(const QString &text)
-{
-    auto textItem = new SimpleTextItem(text, myMusicNotationFont);
-    textItem->setPos(2, 2 - myMusicFontMetrics.ascent());
-
-    // Sticking the text in a QGraphicsItemGroup allows us to offset the
-    // position of the text from its default location
-    auto group = new QGraphicsItemGroup();
-    group->addToGroup(textItem);
-    return group;
-}
-
-QGraphicsItem *SystemRenderer::createPlainTextSymbol(const QString &text,
-                                                     QFont::Style style)
+CachedTextPtr SystemRenderer::getPlainTextSymbol(const QString &text,
+                                                 QFont::Style style)
 {
     myPlainTextFont.setStyle(style);
-
-    auto textItem = new SimpleTextItem(text, myPlainTextFont);
-    textItem->setPos(0, -8);
-
-    auto group = new QGraphicsItemGroup();
-    group->addToGroup(textItem);
-
+    CachedTextPtr symbol = TextCache::get(myPlainTextFont, text);
     myPlainTextFont.setStyle(QFont::StyleNormal);
 
-    return group;
+    return symbol;
 }
 
-/// Creates the text portion of an artificial harmonic, which displays the note.
-QGraphicsItem* SystemRenderer::createArtificialHarmonicText(
-        const Position &position)
+/// Returns the text portion of an artificial harmonic, which displays the
+/// note.
+QString SystemRenderer::getArtificialHarmonicText(const Position &position)
 {
     // Find the note that has the harmonic.
     auto it = boost::range::find_if(position.getNotes(), [] (const Note &note) {
@@ -1045,9 +1147,7 @@ QGraphicsItem* SystemRenderer::createArtificialHarmonicText(
     name.setBassKey(harmonic.getKey());
     name.setBassVariation(harmonic.getVariation());
 
-    return createPlainTextSymbol(
-                QString::fromStdString(boost::lexical_cast<std::string>(name)),
-                QFont::StyleNormal);
+    return QString::fromStdString(boost::lexical_cast<std::string>(name));
 }
 
 void SystemRenderer::drawSymbolsAboveTabStaff(const Staff &staff,
@@ -1055,42 +1155,42 @@ void SystemRenderer::drawSymbolsAboveTabStaff(const Staff &staff,
 {
     for (const SymbolGroup &symbolGroup : layout.getTabStaffAboveSymbols())
     {
-        QGraphicsItem *renderedSymbol = nullptr;
         const double width = symbolGroup.getWidth();
+        const QPointF pos(
+            layout.getPositionX(symbolGroup.getLeftPosition()),
+            layout.getTopTabLine() - LayoutInfo::STAFF_BORDER_SPACING -
+                symbolGroup.getHeight() * LayoutInfo::TAB_SYMBOL_SPACING);
 
         switch(symbolGroup.getSymbolType())
         {
         case SymbolGroup::Bend:
-            renderedSymbol = createBendGroup(symbolGroup, layout);
+            // Bends are positioned differently, since they overlap with the
+            // standard notation staff.
+            drawBendGroup(symbolGroup, layout);
             break;
         case SymbolGroup::LetRing:
-            renderedSymbol = createConnectedSymbolGroup("let ring",
-                                                        QFont::StyleItalic,
-                                                        width, layout);
+            drawConnectedSymbolGroup("let ring", QFont::StyleItalic, width,
+                                     layout, pos);
             break;
         case SymbolGroup::Vibrato:
-            renderedSymbol = drawContinuousFontSymbols(MusicFont::Vibrato,
-                                                       width);
+            drawContinuousFontSymbols(MusicFont::Vibrato, width, pos);
             break;
         case SymbolGroup::WideVibrato:
-            renderedSymbol = drawContinuousFontSymbols(MusicFont::WideVibrato,
-                                                       width);
+            drawContinuousFontSymbols(MusicFont::WideVibrato, width, pos);
             break;
         case SymbolGroup::PalmMuting:
-            renderedSymbol = createConnectedSymbolGroup("P.M.",
-                                                        QFont::StyleNormal,
-                                                        width, layout);
+            drawConnectedSymbolGroup("P.M.", QFont::StyleNormal, width,
+                                     layout, pos);
             break;
         case SymbolGroup::TremoloPicking:
-            renderedSymbol = createTremoloPicking(layout);
+            drawTremoloPicking(layout, pos);
             break;
         case SymbolGroup::Trill:
-            renderedSymbol = createTrill(layout);
+            drawTrill(layout, pos);
             break;
         case SymbolGroup::NaturalHarmonic:
-            renderedSymbol = createConnectedSymbolGroup("N.H.",
-                                                        QFont::StyleNormal,
-                                                        width, layout);
+            drawConnectedSymbolGroup("N.H.", QFont::StyleNormal, width,
+                                     layout, pos);
             break;
         case SymbolGroup::Dynamic:
         {
@@ -1098,13 +1198,12 @@ void SystemRenderer::drawSymbolsAboveTabStaff(const Staff &staff,
                 staff.getDynamics(), symbolGroup.getLeftPosition());
             Q_ASSERT(dynamic);
 
-            renderedSymbol = createDynamic(*dynamic);
+            drawDynamic(*dynamic, pos);
             break;
         }
         case SymbolGroup::ArtificialHarmonic:
-            renderedSymbol = createConnectedSymbolGroup("A.H.",
-                                                        QFont::StyleNormal,
-                                                        width, layout);
+            drawConnectedSymbolGroup("A.H.", QFont::StyleNormal, width,
+                                     layout, pos);
             break;
 #if 0
         case Layout::SymbolVolumeSwell:
@@ -1127,18 +1226,6 @@ void SystemRenderer::drawSymbolsAboveTabStaff(const Staff &staff,
             Q_ASSERT(false);
             break;
         }
-
-        // Bends are positioned differently, since they overlap with the
-        // standard notation staff.
-        if (symbolGroup.getSymbolType() != SymbolGroup::Bend)
-        {
-            renderedSymbol->setPos(
-                layout.getPositionX(symbolGroup.getLeftPosition()),
-                layout.getTopTabLine() - LayoutInfo::STAFF_BORDER_SPACING -
-                    symbolGroup.getHeight() * LayoutInfo::TAB_SYMBOL_SPACING);
-        }
-
-        renderedSymbol->setParentItem(myParentStaff);
     }
 }
 
@@ -1146,30 +1233,24 @@ void SystemRenderer::drawSymbolsAboveStdNotationStaff(const LayoutInfo& layout)
 {
     for (const SymbolGroup &symbolGroup : layout.getStdNotationStaffAboveSymbols())
     {
-        QGraphicsItem *renderedSymbol = nullptr;
+        const QPointF pos(
+            layout.getPositionX(symbolGroup.getLeftPosition()), 0);
 
         switch (symbolGroup.getSymbolType())
         {
         case SymbolGroup::Octave8va:
-            renderedSymbol = createConnectedSymbolGroup("8va",
-                                                        QFont::StyleItalic,
-                                                        symbolGroup.getWidth(),
-                                                        layout);
+            drawConnectedSymbolGroup("8va", QFont::StyleItalic,
+                                     symbolGroup.getWidth(), layout, pos);
             break;
         case SymbolGroup::Octave15ma:
-            renderedSymbol = createConnectedSymbolGroup("15ma",
-                                                        QFont::StyleItalic,
-                                                        symbolGroup.getWidth(),
-                                                        layout);
+            drawConnectedSymbolGroup("15ma", QFont::StyleItalic,
+                                     symbolGroup.getWidth(), layout, pos);
             break;
         default:
             // All symbol types should have been dealt with by now.
             Q_ASSERT(false);
             break;
         }
-
-        renderedSymbol->setPos(layout.getPositionX(symbolGroup.getLeftPosition()), 0);
-        renderedSymbol->setParentItem(myParentStaff);
     }
 }
 
@@ -1178,73 +1259,62 @@ void SystemRenderer::drawSymbolsBelowStdNotationStaff(const LayoutInfo &layout)
     for (const SymbolGroup &symbolGroup :
          layout.getStdNotationStaffBelowSymbols())
     {
-        QGraphicsItem *renderedSymbol = nullptr;
+        const QPointF pos(layout.getPositionX(symbolGroup.getLeftPosition()),
+                          layout.getBottomStdNotationLine() +
+                              layout.getStdNotationStaffBelowSpacing());
 
         switch (symbolGroup.getSymbolType())
         {
         case SymbolGroup::Octave8vb:
-            renderedSymbol = createConnectedSymbolGroup("8vb",
-                                                        QFont::StyleItalic,
-                                                        symbolGroup.getWidth(),
-                                                        layout);
+            drawConnectedSymbolGroup("8vb", QFont::StyleItalic,
+                                     symbolGroup.getWidth(), layout, pos);
             break;
         case SymbolGroup::Octave15mb:
-            renderedSymbol = createConnectedSymbolGroup("15mb",
-                                                        QFont::StyleItalic,
-                                                        symbolGroup.getWidth(),
-                                                        layout);
+            drawConnectedSymbolGroup("15mb", QFont::StyleItalic,
+                                     symbolGroup.getWidth(), layout, pos);
             break;
         default:
             // All symbol types should have been dealt with by now.
             Q_ASSERT(false);
             break;
         }
-
-        renderedSymbol->setPos(layout.getPositionX(symbolGroup.getLeftPosition()),
-                               layout.getBottomStdNotationLine() +
-                               layout.getStdNotationStaffBelowSpacing());
-        renderedSymbol->setParentItem(myParentStaff);
     }
 }
 
-QGraphicsItem *SystemRenderer::createConnectedSymbolGroup(const QString &text,
-                                                          QFont::Style style,
-                                                          double width,
-                                                          const LayoutInfo &layout)
+void SystemRenderer::drawConnectedSymbolGroup(const QString &text,
+                                              QFont::Style style, double width,
+                                              const LayoutInfo &layout,
+                                              const QPointF &pos)
 {
     mySymbolTextFont.setStyle(style);
 
     // Render the description (i.e. "let ring").
-    auto description = new SimpleTextItem(text, mySymbolTextFont);
-
-    auto group = new QGraphicsItemGroup();
-    group->addToGroup(description);
+    const CachedTextPtr description = TextCache::get(mySymbolTextFont, text);
+    getDisplayList(myParentStaff).addText(description, pos);
 
     // Draw dashed line across the remaining positions in the group.
     if (width > layout.getPositionSpacing())
     {
         const double rightEdge = width - 0.5 * layout.getPositionSpacing();
-        const double leftEdge = description->boundingRect().right();
+        const double leftEdge = description->getWidth();
         const double y = LayoutInfo::TAB_SYMBOL_SPACING / 2.0;
 
-        createDashedLine(group, leftEdge, rightEdge, y);
+        drawDashedLine(pos.x() + leftEdge, pos.x() + rightEdge, pos.y() + y);
     }
-
-    return group;
 }
 
-void SystemRenderer::createDashedLine(QGraphicsItemGroup *group, double left,
-                                      double right, double y)
+void SystemRenderer::drawDashedLine(double left, double right, double y)
 {
-    auto line = new QGraphicsLineItem(left, y, right, y);
-    line->setPen(QPen(Qt::black, 1, Qt::DashLine));
-    group->addToGroup(line);
-
-    // Draw a vertical line at the end of the dotted lines.
-    auto lineEnd = new QGraphicsLineItem(
-        line->boundingRect().right(), y, line->boundingRect().right(),
-        y + 0.5 * LayoutInfo::TAB_SYMBOL_SPACING);
-    group->addToGroup(lineEnd);
+    DisplayListItem &displayList = getDisplayList(myParentStaff);
+
+    const QPen pen(Qt::black, 1, Qt::DashLine);
+    displayList.addLine(QLineF(left, y, right, y), pen);
+
+    // Draw a vertical line at the end of the dotted lines, at the right edge
+    // of the dashed line's outline.
+    const double end = right + 0.5 * pen.widthF();
+    displayList.addLine(
+        QLineF(end, y, end, y + 0.5 * LayoutInfo::TAB_SYMBOL_SPACING));
 }
 
 #if 0
@@ -1272,55 +1342,54 @@ QGraphicsItem* SystemRenderer::createVolumeSwell(uint8_t width, const StaffData&
 }
 
 #endif
-QGraphicsItem *SystemRenderer::drawContinuousFontSymbols(QChar symbol,
-                                                         int width)
+
+void SystemRenderer::drawContinuousFontSymbols(QChar symbol, int width,
+                                               const QPointF &pos)
 {
     QFont font = MusicFont::getFont(25);
 
-    const double symbolWidth = QFontMetricsF(font).width(symbol);
+    const double symbolWidth = TextCache::getWidth(font, symbol);
     const int numSymbols = width / symbolWidth;
-    auto text = new SimpleTextItem(QString(numSymbols, symbol), font);
-    text->setPos(0, -25);
 
     // A bit of a hack for getting around the height offset caused by the
     // music font.
-    auto group = new QGraphicsItemGroup();
-    group->addToGroup(text);
-    return group;
+    getDisplayList(myParentStaff)
+        .addText(TextCache::get(font, QString(numSymbols, symbol)),
+                 pos + QPointF(0, -25));
 }
 
-QGraphicsItem *SystemRenderer::createTremoloPicking(const LayoutInfo& layout)
+void SystemRenderer::drawTremoloPicking(const LayoutInfo& layout,
+                                        const QPointF &pos)
 {
     const double offset = LayoutInfo::TAB_SYMBOL_SPACING / 3;
 
-    auto group = new QGraphicsItemGroup();
+    DisplayListItem &displayList = getDisplayList(myParentStaff);
+    const CachedTextPtr line =
+        TextCache::get(myMusicNotationFont, QChar(MusicFont::TremoloPicking));
+    const double x = centerHorizontally(line->getWidth(), 0,
+                                        layout.getPositionSpacing() * 1.25);
 
     for (int i = 0; i < 3; i++)
     {
-        auto line = new SimpleTextItem(QChar(MusicFont::TremoloPicking),
-                                       myMusicNotationFont);
-        centerHorizontally(*line, 0, layout.getPositionSpacing() * 1.25);
-        line->setY(-myMusicFontMetrics.ascent() - 7 + i * offset);
-        group->addToGroup(line);
+        displayList.addText(
+            line, pos + QPointF(x, -TextCache::getAscent(myMusicNotationFont) -
+                                       7 + i * offset));
     }
-
-    return group;
 }
 
-QGraphicsItem *SystemRenderer::createTrill(const LayoutInfo& layout)
+void SystemRenderer::drawTrill(const LayoutInfo& layout, const QPointF &pos)
 {
     QFont font(MusicFont::getFont(21));
 
-    auto text = new SimpleTextItem(QChar(MusicFont::Trill), font);
-    centerHorizontally(*text, 0, layout.getPositionSpacing());
-    text->setY(-18);
-
-    auto group = new QGraphicsItemGroup();
-    group->addToGroup(text);
-    return group;
+    const CachedTextPtr text = TextCache::get(font, QChar(MusicFont::Trill));
+    getDisplayList(myParentStaff)
+        .addText(text,
+                 pos + QPointF(centerHorizontally(text->getWidth(), 0,
+                                                  layout.getPositionSpacing()),
+                               -18));
 }
 
-QGraphicsItem *SystemRenderer::createDynamic(const Dynamic &dynamic)
+void SystemRenderer::drawDynamic(const Dynamic &dynamic, const QPointF &pos)
 {
     QString text = "fff";
     Dynamic::VolumeLevel volume = dynamic.getVolume();
@@ -1342,14 +1411,11 @@ QGraphicsItem *SystemRenderer::createDynamic(const Dynamic &dynamic)
     else if (volume <= Dynamic::ff)
         text = "ff";
 
-    auto textItem = new SimpleTextItem(text, myMusicNotationFont);
-    textItem->setPos(0, -myMusicFontMetrics.ascent() + 10);
-
-    // Sticking the text in a QGraphicsItemGroup allows us to offset the
-    // position of the text from its default location.
-    auto group = new QGraphicsItemGroup();
-    group->addToGroup(textItem);
-    return group;
+    // Offset the text from its default location.
+    getDisplayList(myParentStaff)
+        .addText(TextCache::get(myMusicNotationFont, text),
+                 pos + QPointF(0, -TextCache::getAscent(myMusicNotationFont) +
+                                      10));
 }
 
 void SystemRenderer::drawStdNotation(const System &system, const Staff &staff,
@@ -1387,58 +1453,40 @@ void SystemRenderer::drawStdNotation(const System &system, const Staff &staff,
 
     QFont default_font(MusicFont::getFont(MusicFont::DEFAULT_FONT_SIZE));
     QFont grace_font(MusicFont::getFont(MusicFont::GRACE_NOTE_SIZE));
-    QFontMetricsF default_fm(default_font);
-    QFontMetricsF grace_fm(grace_font);
+    DisplayListItem &displayList = getDisplayList(myParentStaff);
 
     for (const StdNotationNote &note : notes)
     {
         const QFont *font = note.isGraceNote() ? &grace_font : &default_font;
-        const QFontMetricsF *fm = note.isGraceNote() ? &grace_fm : &default_fm;
 
         const QChar noteHead = note.getNoteHeadSymbol();
-        const double noteHeadWidth = fm->width(noteHead);
+        const double noteHeadWidth = TextCache::getWidth(*font, noteHead);
 
         const QString accidentalText = note.getAccidentalText();
-        const double accidentalWidth = fm->width(accidentalText);
+        const double accidentalWidth =
+            TextCache::getWidth(*font, accidentalText);
 
         const double x = layout.getPositionX(note.getPosition()) +
                 0.5 * (layout.getPositionSpacing() - noteHeadWidth) -
                 accidentalWidth;
         const double y =
-            note.getY() + layout.getTopStdNotationLine() - fm->ascent();
-
-        QGraphicsItemGroup *group = nullptr;
-        auto text = new SimpleTextItem(accidentalText + noteHead, *font);
+            note.getY() + layout.getTopStdNotationLine() -
+            TextCache::getAscent(*font);
 
         if (note.isDotted() || note.isDoubleDotted())
         {
-            group = new QGraphicsItemGroup();
             const double dotX = noteHeadWidth + 2;
 
-            const QChar dot(MusicFont::Dot);
-            auto dotText = new SimpleTextItem(dot, *font);
-            dotText->setPos(dotX, 0);
-            group->addToGroup(dotText);
+            const CachedTextPtr dot =
+                TextCache::get(*font, QChar(MusicFont::Dot));
+            displayList.addText(dot, QPointF(x + dotX, y));
 
             if (note.isDoubleDotted())
-            {
-                auto dotText2 = new SimpleTextItem(dot, *font);
-                dotText2->setPos(dotX + 4, 0);
-                group->addToGroup(dotText2);
-            }
+                displayList.addText(dot, QPointF(x + dotX + 4, y));
         }
 
-        if (group)
-        {
-            group->addToGroup(text);
-            group->setPos(x, y);
-            group->setParentItem(myParentStaff);
-        }
-        else
-        {
-            text->setPos(x, y);
-            text->setParentItem(myParentStaff);
-        }
+        displayList.addText(TextCache::get(*font, accidentalText + noteHead),
+                            QPointF(x, y));
 
         const int position = note.getPosition();
         minNoteLocations[position] = std::min(minNoteLocations[position],
@@ -1458,8 +1506,8 @@ void SystemRenderer::drawStdNotation(const System &system, const Staff &staff,
 
         for (const BeamGroup &group : beamGroups)
         {
-            group.drawStems(myParentStaff, stems, myMusicNotationFont,
-                            myMusicFontMetrics, layout);
+            group.drawStems(getDisplayList(myParentStaff), stems,
+                            myMusicNotationFont, layout);
         }
 
         const Voice &voice = staff.getVoices()[v];
@@ -1503,9 +1551,8 @@ void SystemRenderer::drawTies(const Voice &voice,
                               ? -1.25 * LayoutInfo::STD_NOTATION_LINE_SPACING
                               : 0.25 * LayoutInfo::STD_NOTATION_LINE_SPACING);
 
-        auto arc = new AntialiasedPathItem(path);
-        arc->setPos(prevX, y);
-        arc->setParentItem(myParentStaff);
+        getDisplayList(myParentStaff)
+            .addAntialiasedPath(path.translated(prevX, y));
     }
 }
 
@@ -1562,34 +1609,22 @@ void SystemRenderer::drawIrregularGroups(const Voice &voice,
         font.setItalic(true);
         font.setPixelSize(18);
 
-        QFontMetricsF fm(font);
-        const double textWidth = fm.width(text);
+        const double textWidth = TextCache::getWidth(font, text);
         const double centreX = leftX + (rightX - (leftX + textWidth)) / 2.0;
 
-        auto textItem = new SimpleTextItem(text, font);
-        textItem->setPos(centreX, y2 - font.pixelSize());
-        textItem->setParentItem(myParentStaff);
+        DisplayListItem &displayList = getDisplayList(myParentStaff);
+        displayList.addText(TextCache::get(font, text),
+                            QPointF(centreX, y2 - font.pixelSize()));
 
         const double lineWidth =
             std::max(0.0, 0.5 * (rightX - leftX - textWidth - 10));
 
         // Draw the two horizontal line segments across the group, and the two
         // vertical lines on either end.
-        QGraphicsLineItem *horizLine1 = new QGraphicsLineItem();
-        horizLine1->setLine(leftX, y2, leftX + lineWidth, y2);
-        horizLine1->setParentItem(myParentStaff);
-
-        QGraphicsLineItem *horizLine2 = new QGraphicsLineItem();
-        horizLine2->setLine(rightX - lineWidth, y2, rightX, y2);
-        horizLine2->setParentItem(myParentStaff);
-
-        QGraphicsLineItem *vertLine1 = new QGraphicsLineItem();
-        vertLine1->setLine(leftX, y1, leftX, y2);
-        vertLine1->setParentItem(myParentStaff);
-
-        QGraphicsLineItem *vertLine2 = new QGraphicsLineItem();
-        vertLine2->setLine(rightX, y1, rightX, y2);
-        vertLine2->setParentItem(myParentStaff);
+        displayList.addLine(QLineF(leftX, y2, leftX + lineWidth, y2));
+        displayList.addLine(QLineF(rightX - lineWidth, y2, rightX, y2));
+        displayList.addLine(QLineF(leftX, y1, leftX, y2));
+        displayList.addLine(QLineF(rightX, y1, rightX, y2));
     }
 }
 
@@ -1610,39 +1645,34 @@ void SystemRenderer::drawMultiBarRest(const System &system,
                 LayoutInfo::STAFF_WIDTH - layout.getPositionSpacing() / 2.0);
 
     // Draw the measure count.
-    auto measureCountText =
-        new SimpleTextItem(QString::number(measureCount), myMusicNotationFont);
+    DisplayListItem &displayList = getDisplayList(myParentStaff);
+    const CachedTextPtr measureCountText =
+        TextCache::get(myMusicNotationFont, QString::number(measureCount));
 
-    centerHorizontally(*measureCountText, leftX, rightX);
-    measureCountText->setY(layout.getTopStdNotationLine() -
-                           myMusicFontMetrics.ascent());
-    measureCountText->setParentItem(myParentStaff);
+    displayList.addText(
+        measureCountText,
+        QPointF(centerHorizontally(measureCountText->getWidth(), leftX, rightX),
+                layout.getTopStdNotationLine() -
+                    TextCache::getAscent(myMusicNotationFont)));
 
     // Draw symbol across std. notation staff.
-    auto vertLineLeft =
-        new QGraphicsLineItem(leftX, layout.getStdNotationLine(2), leftX,
-                              layout.getStdNotationLine(4));
-    vertLineLeft->setParentItem(myParentStaff);
-
-    auto vertLineRight =
-        new QGraphicsLineItem(rightX, layout.getStdNotationLine(2), rightX,
-                              layout.getStdNotationLine(4));
-    vertLineRight->setParentItem(myParentStaff);
-
-    auto horizontalLine = new QGraphicsRectItem(
-        leftX, layout.getStdNotationLine(2) +
-                   0.5 * LayoutInfo::STD_NOTATION_LINE_SPACING,
-        rightX - leftX, LayoutInfo::STD_NOTATION_LINE_SPACING * 0.9);
-
-    horizontalLine->setBrush(QBrush(Qt::black));
-    horizontalLine->setParentItem(myParentStaff);
+    displayList.addLine(QLineF(leftX, layout.getStdNotationLine(2), leftX,
+                               layout.getStdNotationLine(4)));
+    displayList.addLine(QLineF(rightX, layout.getStdNotationLine(2), rightX,
+                               layout.getStdNotationLine(4)));
+
+    displayList.addRect(
+        QRectF(leftX, layout.getStdNotationLine(2) +
+                          0.5 * LayoutInfo::STD_NOTATION_LINE_SPACING,
+               rightX - leftX, LayoutInfo::STD_NOTATION_LINE_SPACING * 0.9),
+        QPen(), QBrush(Qt::black));
 }
 
 void SystemRenderer::drawRest(const Position &pos, double x, const LayoutInfo &layout)
 {
     // Position it approximately in the middle of the staff.
     double y = 2 * LayoutInfo::STD_NOTATION_LINE_SPACING -
-            myMusicFontMetrics.ascent();
+            TextCache::getAscent(myMusicNotationFont);
 
     QChar symbol;
     switch (pos.getDurationType())
@@ -1672,36 +1702,42 @@ void SystemRenderer::drawRest(const Position &pos, double x, const LayoutInfo &l
         break;
     }
 
-    auto group = new QGraphicsItemGroup();
-    auto text = new SimpleTextItem(symbol, myMusicNotationFont);
-    text->setPos(0, y);
-    group->addToGroup(text);
+    const CachedTextPtr text = TextCache::get(myMusicNotationFont, symbol);
 
     // Draw dots if necessary.
-    const QChar dot = MusicFont::Dot;
+    const CachedTextPtr dot =
+        TextCache::get(myMusicNotationFont, QChar(MusicFont::Dot));
     const double dotX = myMusicNotationFont.pixelSize() / 2.0;
     // Position just below second line of staff.
     const double dotY = 1.6 * LayoutInfo::STD_NOTATION_LINE_SPACING -
-            myMusicFontMetrics.ascent();
+            TextCache::getAscent(myMusicNotationFont);
 
-    if (pos.hasProperty(Position::Dotted) ||
-        pos.hasProperty(Position::DoubleDotted))
-    {
-        auto dotText = new SimpleTextItem(dot, myMusicNotationFont);
-        dotText->setPos(dotX, dotY);
-        group->addToGroup(dotText);
+    const bool dotted = pos.hasProperty(Position::Dotted) ||
+                        pos.hasProperty(Position::DoubleDotted);
+    const bool doubleDotted = pos.hasProperty(Position::DoubleDotted);
 
-        if (pos.hasProperty(Position::DoubleDotted))
-        {
-            auto dotText2 = new SimpleTextItem(dot, myMusicNotationFont);
-            dotText2->setPos(dotX + 4, dotY);
-            group->addToGroup(dotText2);
-        }
+    // Center the rest along with its dots.
+    double width = text->getWidth();
+    if (dotted)
+    {
+        width = std::max(width,
+                         dotX + (doubleDotted ? 4 : 0) + dot->getWidth());
     }
 
-    centerHorizontally(*group, x, x + layout.getPositionSpacing() * 1.25);
-    group->setY(layout.getTopStdNotationLine());
-    group->setParentItem(myParentStaff);
+    const QPointF origin(
+        centerHorizontally(width, x, x + layout.getPositionSpacing() * 1.25),
+        layout.getTopStdNotationLine());
+
+    DisplayListItem &displayList = getDisplayList(myParentStaff);
+    displayList.addText(text, origin + QPointF(0, y));
+
+    if (dotted)
+    {
+        displayList.addText(dot, origin + QPointF(dotX, dotY));
+
+        if (doubleDotted)
+            displayList.addText(dot, origin + QPointF(dotX + 4, dotY));
+    }
 }
 
 void SystemRenderer::drawLedgerLines(
@@ -1756,8 +1792,7 @@ void SystemRenderer::drawLedgerLines(
         }
     }
 
-    auto ledgerlines = new QGraphicsPathItem(path);
-    ledgerlines->setParentItem(myParentStaff);
+    getDisplayList(myParentStaff).addPath(path);
 }
 
 static double getBendHeight(Bend::DrawPoint point, const Note &note,
@@ -1774,10 +1809,10 @@ static double getBendHeight(Bend::DrawPoint point, const Note &note,
         return layout.getTopTabLine() - LayoutInfo::TAB_SYMBOL_SPACING * 2.5;
 }
 
-void SystemRenderer::createBend(QGraphicsItemGroup *group, double left,
-                                double right, double yStart, double yEnd,
-                                int pitch, bool prebend)
+void SystemRenderer::drawBend(double left, double right, double yStart,
+                              double yEnd, int pitch, bool prebend)
 {
+    DisplayListItem &displayList = getDisplayList(myParentStaff);
     QPainterPath path;
 
     // Draw an arc for the bend.
@@ -1795,7 +1830,7 @@ void SystemRenderer::createBend(QGraphicsItemGroup *group, double left,
         path.lineTo(right, yEnd);
     }
 
-    group->addToGroup(new AntialiasedPathItem(path));
+    displayList.addAntialiasedPath(path);
 
     // Draw arrow head, and choose the correct orientation depending on whether
     // the bend is going up or down.
@@ -1806,28 +1841,28 @@ void SystemRenderer::createBend(QGraphicsItemGroup *group, double left,
                << QPointF(right, (yEnd < yStart) ? yEnd - ARROW_WIDTH
                                                  : yEnd + ARROW_WIDTH);
 
-    auto *arrow = new QGraphicsPolygonItem(arrowShape);
-    arrow->setBrush(QBrush(Qt::black));
-    group->addToGroup(arrow);
+    QPainterPath arrow;
+    arrow.addPolygon(arrowShape);
+    arrow.closeSubpath();
+    displayList.addPath(arrow, QPen(), QBrush(Qt::black));
 
     // Draw text for the bent pitch (e.g. "Full", "3/4", etc). Don't draw the
     // text if the bend is returning to standard pitch.
     if (pitch != 0)
     {
         mySymbolTextFont.setStyle(QFont::StyleNormal);
-        auto bendText = new SimpleTextItem(
-            QString::fromStdString(Bend::getPitchText(pitch)),
-            mySymbolTextFont);
-        bendText->setPos(right - 0.5 * bendText->boundingRect().width(),
-                         yEnd - 1.75 * mySymbolTextFont.pixelSize());
-        group->addToGroup(bendText);
+        const CachedTextPtr bendText = TextCache::get(
+            mySymbolTextFont,
+            QString::fromStdString(Bend::getPitchText(pitch)));
+        displayList.addText(
+            bendText, QPointF(right - 0.5 * bendText->getWidth(),
+                              yEnd - 1.75 * mySymbolTextFont.pixelSize()));
     }
 }
 
-QGraphicsItem *SystemRenderer::createBendGroup(const SymbolGroup &group,
-                                               const LayoutInfo &layout)
+void SystemRenderer::drawBendGroup(const SymbolGroup &group,
+                                   const LayoutInfo &layout)
 {
-    auto itemGroup = new QGraphicsItemGroup();
     double prevX = 0.0;
 
     for (int i = group.getLeftPosition(); i < group.getRightPosition(); ++i)
@@ -1880,25 +1915,24 @@ QGraphicsItem *SystemRenderer::createBendGroup(const SymbolGroup &group,
             const double yRelease = yEnd - 0.5 * layout.getTabLineSpacing();
             
             if (type == Bend::ImmediateRelease)
-                createDashedLine(itemGroup, prevX, rightX, yStart);
+                drawDashedLine(prevX, rightX, yStart);
             else if (type == Bend::GradualRelease)
             {
                 // Draw a dashed line to the original bend.
-                auto line = new QGraphicsLineItem(
-                    prevX, yStart, x + layout.getPositionSpacing(), yStart);
-                line->setPen(QPen(Qt::black, 1, Qt::DashLine));
-                itemGroup->addToGroup(line);
+                getDisplayList(myParentStaff)
+                    .addLine(QLineF(prevX, yStart,
+                                    x + layout.getPositionSpacing(), yStart),
+                             QPen(Qt::black, 1, Qt::DashLine));
 
                 // Draw the bend down to the new pitch.
-                createBend(itemGroup, x + layout.getPositionSpacing(), rightX,
-                           yStart, yRelease, bend.getReleasePitch(), false);
+                drawBend(x + layout.getPositionSpacing(), rightX, yStart,
+                         yRelease, bend.getReleasePitch(), false);
             }
             else if (type == Bend::NormalBend || type == Bend::BendAndHold ||
                      type == Bend::PreBend || type == Bend::PreBendAndHold)
             {
-                createBend(
-                    itemGroup, leftX, rightX, yStart, yEnd, bend.getBentPitch(),
-                    type == Bend::PreBend || type == Bend::PreBendAndHold);
+                drawBend(leftX, rightX, yStart, yEnd, bend.getBentPitch(),
+                         type == Bend::PreBend || type == Bend::PreBendAndHold);
             }
             else if (type == Bend::BendAndRelease ||
                      type == Bend::PreBendAndRelease)
@@ -1916,19 +1950,16 @@ QGraphicsItem *SystemRenderer::createBendGroup(const SymbolGroup &group,
                 }
 
                 const double yMiddle = getBendHeight(drawPoint, note, layout);
-                createBend(itemGroup, leftX, middleX, yStart, yMiddle,
-                           bend.getBentPitch(),
-                           type == Bend::PreBendAndRelease);
+                drawBend(leftX, middleX, yStart, yMiddle, bend.getBentPitch(),
+                         type == Bend::PreBendAndRelease);
 
                 // Draw the second part of the bend.
-                createBend(itemGroup, middleX, rightX, yMiddle, yRelease,
-                           bend.getReleasePitch(), false);
+                drawBend(middleX, rightX, yMiddle, yRelease,
+                         bend.getReleasePitch(), false);
             }
 
             prevX = rightX;
             break;
         }
     }
-
-    return itemGroup;
 }
@@ -21,11 +21,14 @@
 #include <map>
 #include <painters/layoutinfo.h>
 #include <painters/musicfont.h>
-#include <QFontMetricsF>
+#include <painters/textcache.h>
+#include <QPointF>
 #include <score/staff.h>
+#include <vector>
 
+class DisplayListItem;
+class LayoutCache;
 class QGraphicsItem;
-class QGraphicsItemGroup;
 class QGraphicsRectItem;
 class Score;
 class ScoreArea;
@@ -39,9 +42,44 @@ public:
     SystemRenderer(const ScoreArea *score_area, const Score &score,
                    const ViewOptions &view_options);
 
+    /// The layout of each staff in a system. Staves that are hidden by the
+    /// active view filter have a null entry.
+    typedef std::vector<LayoutConstPtr> SystemLayout;
+
+    /// Computes the layout of each staff in the system. This does not create
+    /// any graphics items, so it is safe to call from a worker thread.
+    /// If a cache is provided, the layout is only computed if the system has
+    /// changed since it was cached.
+    static SystemLayout computeLayout(const Score &score,
+                                      const ViewOptions &view_options,
+                                      const System &system, int systemIndex,
+                                      LayoutCache *cache = nullptr);
+
+    /// Returns the height of a system with the given layout, without needing
+    /// to render it.
+    static double getHeight(const SystemLayout &layouts);
+
     QGraphicsItem *operator()(const System &system, int systemIndex);
 
+    /// Renders the system using a layout that was computed by
+    /// computeLayout(). This must be called from the GUI thread.
+    QGraphicsItem *operator()(const System &system, int systemIndex,
+                              const SystemLayout &layouts);
+
 private:
+    /// Returns the display list that symbols below the parent (the system or
+    /// the current staff) are drawn into, creating it if necessary.
+    DisplayListItem &getDisplayList(QGraphicsItem *parent);
+
+    /// Adds an item that is not drawn from a display list (e.g. a barline).
+    /// Symbols that are drawn afterwards go into a new display list, so that
+    /// they are stacked above the item.
+    void addItem(QGraphicsItem *item, QGraphicsItem *parent);
+
+    /// Builds the display list's index of click targets, and stops adding to
+    /// it.
+    static void finishDisplayList(DisplayListItem *&displayList);
+
     /// Draws the tab clef.
     void drawTabClef(double x, const LayoutInfo &layout,
                      const ScoreLocation &location);
@@ -53,14 +91,13 @@ private:
     /// Draws the tab notes for all notes in the staff.
     void drawTabNotes(const Staff &staff, const LayoutConstPtr &layout);
 
-    /// Centers an item, by using its width to calculate the necessary
-    /// offset from xmin.
-    static void centerHorizontally(QGraphicsItem &item, double xmin,
-                                   double xmax);
+    /// Returns the position that centers a symbol with the given width
+    /// between xmin and xmax.
+    static double centerHorizontally(double width, double xmin, double xmax);
 
-    /// Vertically centers a system symbol between y and y +
-    /// LayoutInfo::SYSTEM_SYMBOL_SPACING.
-    static void centerSymbolVertically(QGraphicsItem &item, double y);
+    /// Returns the position that vertically centers a system symbol with the
+    /// given height between y and y + LayoutInfo::SYSTEM_SYMBOL_SPACING.
+    static double centerSymbolVertically(double height, double y);
 
     /// Draws a arpeggio up/down at the given position.
     void drawArpeggio(const Position &position, double x,
@@ -99,26 +136,21 @@ private:
     /// (hammerons, slides, etc).
     void drawSymbolsBelowTabStaff(const LayoutInfo &layout);
 
-    /// Creates a pick stroke symbol using the given character.
-    QGraphicsItem *createPickStroke(const QString &text);
-
-    /// Creates a plain text item - useful for symbols that don't use the
-    /// music font (hammerons, slides, etc).
-    QGraphicsItem *createPlainTextSymbol(const QString &text,
-                                         QFont::Style style);
+    /// Returns the text for a symbol that doesn't use the music font
+    /// (hammerons, slides, etc).
+    CachedTextPtr getPlainTextSymbol(const QString &text, QFont::Style style);
 
     /// Draws symbols that appear above the standard notation staff (e.g. 8va).
     void drawSymbolsAboveStdNotationStaff(const LayoutInfo &layout);
 
     /// Draws symbols that are grouped across multiple positions
     /// (i.e. consecutive "let ring" symbols).
-    QGraphicsItem *createConnectedSymbolGroup(const QString &text,
-                                              QFont::Style style, double width,
-                                              const LayoutInfo &layout);
+    void drawConnectedSymbolGroup(const QString &text, QFont::Style style,
+                                  double width, const LayoutInfo &layout,
+                                  const QPointF &pos);
 
-    /// Create a dashed line in the given location.
-    void createDashedLine(QGraphicsItemGroup *group, double left, double right,
-                          double y);
+    /// Draws a dashed line in the given location.
+    void drawDashedLine(double left, double right, double y);
 
     /// Draws symbols that appear below the standard notation staff (e.g. 8vb).
     void drawSymbolsBelowStdNotationStaff(const LayoutInfo &layout);
@@ -134,27 +166,27 @@ private:
     void drawSymbolsAboveTabStaff(const Staff &staff, const LayoutInfo &layout);
 
     /// Draws a sequence of continuous music symbols (e.g. vibrato).
-    QGraphicsItem *drawContinuousFontSymbols(QChar symbol, int width);
+    void drawContinuousFontSymbols(QChar symbol, int width,
+                                   const QPointF &pos);
 
-    /// Creates a tremolo picking symbol.
-    QGraphicsItem *createTremoloPicking(const LayoutInfo &layout);
+    /// Draws a tremolo picking symbol.
+    void drawTremoloPicking(const LayoutInfo &layout, const QPointF &pos);
 
-    /// Creates a trill symbol.
-    QGraphicsItem *createTrill(const LayoutInfo &layout);
+    /// Draws a trill symbol.
+    void drawTrill(const LayoutInfo &layout, const QPointF &pos);
 
-    /// Creates an artificial harmonic symbol.
-    QGraphicsItem *createArtificialHarmonicText(const Position &position);
+    /// Returns the text of an artificial harmonic symbol.
+    static QString getArtificialHarmonicText(const Position &position);
 
-    /// Creates a dynamic symbol.
-    QGraphicsItem *createDynamic(const Dynamic &dynamic);
+    /// Draws a dynamic symbol.
+    void drawDynamic(const Dynamic &dynamic, const QPointF &pos);
 
     /// Draws a group of bends.
-    QGraphicsItem *createBendGroup(const SymbolGroup &group,
-                                   const LayoutInfo &layout);
-    
+    void drawBendGroup(const SymbolGroup &group, const LayoutInfo &layout);
+
     /// Draws a single bend.
-    void createBend(QGraphicsItemGroup *group, double left, double right,
-                    double yStart, double yEnd, int pitch, bool prebend);
+    void drawBend(double left, double right, double yStart, double yEnd,
+                  int pitch, bool prebend);
 
     /// Draws notes, beams, and rests.
     void drawStdNotation(const System &system, const Staff &staff,
@@ -186,7 +218,7 @@ private:
 
     /// Draws a single slide between the given positions.
     void drawSlide(const LayoutInfo &layout, int string, bool slideUp,
-                   int position1, int position2) const;
+                   int position1, int position2);
 
     const ScoreArea *myScoreArea;
     const Score &myScore;
@@ -194,9 +226,11 @@ private:
 
     QGraphicsRectItem *myParentSystem;
     QGraphicsItem *myParentStaff;
+    /// The display lists that symbols are currently being drawn into.
+    DisplayListItem *mySystemDisplayList;
+    DisplayListItem *myStaffDisplayList;
 
     QFont myMusicNotationFont;
-    QFontMetricsF myMusicFontMetrics;
     QFont myPlainTextFont;
     QFont mySymbolTextFont;
     QFont myRehearsalSignFont;
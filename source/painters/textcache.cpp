@@ -0,0 +1,152 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#include "textcache.h"
+
+#include <map>
+#include <mutex>
+#include <QFontMetricsF>
+#include <QHash>
+
+namespace
+{
+/// Discard the cached text if it grows larger than this, e.g. after a long
+/// editing session with many different lyrics or chord names.
+const size_t MAX_ENTRIES = 1 << 16;
+
+struct Cache
+{
+    std::mutex myMutex;
+    std::map<QFont, QHash<QString, CachedTextPtr>> myFonts;
+    TextCache::Statistics myStatistics;
+};
+
+Cache &getCache()
+{
+    // This is intentionally never destroyed, since the fonts must not outlive
+    // the QApplication.
+    static Cache *cache = new Cache();
+    return *cache;
+}
+}
+
+CachedText::CachedText(const QFont &font, const QString &text, double ascent,
+                       double width, double height)
+    : myFont(font),
+      myText(text),
+      myAscent(ascent),
+      myWidth(width),
+      myHeight(height)
+{
+}
+
+const QStaticText &CachedText::getStaticText() const
+{
+    if (!myStaticText)
+    {
+        myStaticText.reset(new QStaticText(myText));
+        myStaticText->setTextFormat(Qt::PlainText);
+    }
+
+    return *myStaticText;
+}
+
+size_t CachedText::getMemoryUsage() const
+{
+    // Once the text has been drawn, the layout stores a glyph and position for
+    // each character.
+    const size_t length = static_cast<size_t>(getText().size());
+    return sizeof(CachedText) +
+           length * (sizeof(QChar) + sizeof(quint32) + sizeof(QPointF));
+}
+
+TextCache::Statistics::Statistics()
+    : myHits(0), myMisses(0), myNumEntries(0), myMemoryUsage(0)
+{
+}
+
+double TextCache::Statistics::getHitRate() const
+{
+    const size_t lookups = myHits + myMisses;
+    return lookups ? static_cast<double>(myHits) / lookups : 0.0;
+}
+
+CachedTextPtr TextCache::get(const QFont &font, const QString &text)
+{
+    Cache &cache = getCache();
+
+    {
+        std::lock_guard<std::mutex> lock(cache.myMutex);
+
+        auto font_it = cache.myFonts.find(font);
+        if (font_it != cache.myFonts.end())
+        {
+            auto text_it = font_it->second.constFind(text);
+            if (text_it != font_it->second.constEnd())
+            {
+                ++cache.myStatistics.myHits;
+                return text_it.value();
+            }
+        }
+    }
+
+    // Measure the text without holding the lock, since this is the expensive
+    // part.
+    QFontMetricsF fm(font);
+    auto entry = std::make_shared<const CachedText>(
+        font, text, fm.ascent(), fm.width(text), fm.height());
+
+    std::lock_guard<std::mutex> lock(cache.myMutex);
+    Statistics &stats = cache.myStatistics;
+    ++stats.myMisses;
+
+    if (stats.myNumEntries >= MAX_ENTRIES)
+    {
+        cache.myFonts.clear();
+        stats.myNumEntries = 0;
+        stats.myMemoryUsage = 0;
+    }
+
+    // Another thread may have added the same text in the meantime.
+    QHash<QString, CachedTextPtr> &texts = cache.myFonts[font];
+    auto text_it = texts.constFind(text);
+    if (text_it != texts.constEnd())
+        return text_it.value();
+
+    texts.insert(text, entry);
+    ++stats.myNumEntries;
+    stats.myMemoryUsage += entry->getMemoryUsage();
+
+    return entry;
+}
+
+TextCache::Statistics TextCache::getStatistics()
+{
+    Cache &cache = getCache();
+    std::lock_guard<std::mutex> lock(cache.myMutex);
+    return cache.myStatistics;
+}
+
+void TextCache::clear()
+{
+    Cache &cache = getCache();
+    std::lock_guard<std::mutex> lock(cache.myMutex);
+
+    cache.myFonts.clear();
+    cache.myStatistics.myNumEntries = 0;
+    cache.myStatistics.myMemoryUsage = 0;
+}
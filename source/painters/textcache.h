@@ -0,0 +1,108 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#ifndef PAINTERS_TEXTCACHE_H
+#define PAINTERS_TEXTCACHE_H
+
+#include <cstddef>
+#include <memory>
+#include <QFont>
+#include <QStaticText>
+#include <QString>
+
+/// A string that has been measured and laid out with a particular font. This
+/// is immutable and shared by every item that displays the same text.
+class CachedText
+{
+public:
+    CachedText(const QFont &font, const QString &text, double ascent,
+               double width, double height);
+
+    const QFont &getFont() const { return myFont; }
+    const QString &getText() const { return myText; }
+
+    /// Returns the text layout, creating it if necessary. This must only be
+    /// called from the GUI thread.
+    const QStaticText &getStaticText() const;
+
+    double getAscent() const { return myAscent; }
+    double getWidth() const { return myWidth; }
+    double getHeight() const { return myHeight; }
+
+    /// Returns the approximate number of bytes used by the entry.
+    size_t getMemoryUsage() const;
+
+private:
+    const QFont myFont;
+    const QString myText;
+    /// Keeps the text layout after it has been drawn once, so that it doesn't
+    /// need to be shaped again for each repaint. This is created when the
+    /// text is first drawn rather than on the thread that measured it.
+    mutable std::unique_ptr<QStaticText> myStaticText;
+    const double myAscent;
+    const double myWidth;
+    const double myHeight;
+};
+
+typedef std::shared_ptr<const CachedText> CachedTextPtr;
+
+/// Process-wide cache of text metrics and layouts. A score contains the same
+/// few hundred strings (fret numbers, music symbols, etc) many times over, so
+/// each distinct font and string is only measured once.
+/// This can be used from any thread, but the text should only be measured off
+/// the GUI thread if QFontDatabase::supportsThreadedFontRendering() is true.
+class TextCache
+{
+public:
+    struct Statistics
+    {
+        Statistics();
+
+        /// Returns the fraction of lookups that were found in the cache.
+        double getHitRate() const;
+
+        size_t myHits;
+        size_t myMisses;
+        size_t myNumEntries;
+        /// Approximate memory used by the cached entries, in bytes.
+        size_t myMemoryUsage;
+    };
+
+    /// Returns the layout of the text with the given font, creating it if
+    /// necessary.
+    static CachedTextPtr get(const QFont &font, const QString &text);
+
+    /// Returns the width of the text, as QFontMetricsF::width() would.
+    static double getWidth(const QFont &font, const QString &text)
+    {
+        return get(font, text)->getWidth();
+    }
+
+    /// Returns the font's ascent, as QFontMetricsF::ascent() would.
+    static double getAscent(const QFont &font)
+    {
+        return get(font, QString())->getAscent();
+    }
+
+    static Statistics getStatistics();
+
+    /// Removes all entries from the cache. Items that are using an entry
+    /// keep it alive until they are destroyed.
+    static void clear();
+};
+
+#endif
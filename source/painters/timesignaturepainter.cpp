@@ -19,6 +19,7 @@
 
 #include <app/pubsub/clickpubsub.h>
 #include <painters/musicfont.h>
+#include <painters/textcache.h>
 #include <QCursor>
 #include <QPainter>
 #include <score/timesignature.h>
@@ -86,7 +87,7 @@ void TimeSignaturePainter::drawNumber(QPainter* painter, const double y,
     QString text = QString::number(number);
     QFont font = MusicFont::getFont(27);
 
-    const double width = QFontMetricsF(font).width(text);
+    const double width = TextCache::getWidth(font, text);
     const double x = LayoutInfo::centerItem(0, LayoutInfo::getWidth(myTimeSignature),
                                             width);
 
@@ -18,13 +18,38 @@
 #include "verticallayout.h"
 
 #include <algorithm>
+#include <iterator>
+#include <limits>
+
+VerticalLayout::VerticalLayout()
+{
+    mySkyline.emplace(std::numeric_limits<int>::min(), 0);
+}
 
 int VerticalLayout::addBox(int left, int right, int height)
 {
-    heights.resize(std::max<size_t>(heights.size(), right + 1));
-    const int newHeight =
-        *std::max_element(heights.begin() + left, heights.begin() + right) +
-        height;
-    std::fill_n(heights.begin() + left, right - left, newHeight);
+    // The interval containing the left edge of the box.
+    auto first = std::prev(mySkyline.upper_bound(left));
+
+    // An empty box is placed above the height at its position.
+    if (left >= right)
+        return first->second + height;
+
+    // Find the highest interval overlapping the box.
+    auto last = mySkyline.lower_bound(right);
+    int maxHeight = first->second;
+    for (auto it = std::next(first); it != last; ++it)
+        maxHeight = std::max(maxHeight, it->second);
+
+    const int newHeight = maxHeight + height;
+
+    // Keep the previous height after the end of the box.
+    if (last == mySkyline.end() || last->first != right)
+        mySkyline.emplace_hint(last, right, std::prev(last)->second);
+
+    // Replace the intervals covered by the box. Since every interval that is
+    // searched is also removed, adding a box takes amortized O(log n) time.
+    mySkyline.erase(mySkyline.upper_bound(left), mySkyline.find(right));
+    mySkyline[left] = newHeight;
     return newHeight;
 }
@@ -18,17 +18,25 @@
 #ifndef PAINTERS_VERTICALLAYOUT_H
 #define PAINTERS_VERTICALLAYOUT_H
 
-#include <vector>
+#include <map>
 
+/// Stacks boxes that span a range of horizontal positions, such as groups of
+/// symbols above the staff, so that they don't overlap.
 class VerticalLayout
 {
 public:
-    /// Adds a box to the layout. Returns the y-coordinate where the box should
-    /// be placed.
+    VerticalLayout();
+
+    /// Adds a box spanning the positions [left, right) to the layout. Returns
+    /// the y-coordinate where the box should be placed.
+    /// If left == right, the box is placed above the position but does not
+    /// occupy any space.
     int addBox(int left, int right, int height);
 
 private:
-    std::vector<int> heights;
+    /// The height of the layout, stored as a map from the start of each
+    /// interval to its height. Each interval ends where the next one starts.
+    std::map<int, int> mySkyline;
 };
 
 #endif
@@ -0,0 +1,232 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "binaryserialization.h"
+
+#include <boost/functional/hash.hpp>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <ostream>
+
+namespace ScoreUtils
+{
+/// Identifies a binary archive. A JSON archive always starts with '{'.
+static const char MAGIC[] = { 'P', 'T', 'B', '\0' };
+static const size_t MAGIC_SIZE = sizeof(MAGIC);
+
+bool isBinaryArchive(std::istream &is)
+{
+    return is.peek() == MAGIC[0];
+}
+
+BinaryInputArchive::BinaryInputArchive(std::istream &is)
+{
+    if (!is)
+        throw std::runtime_error("Could not open stream");
+
+    myData.assign(std::istreambuf_iterator<char>(is),
+                  std::istreambuf_iterator<char>());
+    myPos = myData.data();
+    myEnd = myPos + myData.size();
+
+    if (myData.size() < MAGIC_SIZE ||
+        std::memcmp(myPos, MAGIC, MAGIC_SIZE) != 0)
+    {
+        throw std::runtime_error("Invalid binary data");
+    }
+    myPos += MAGIC_SIZE;
+
+    myVersion = static_cast<FileVersion>(readSignedVarint());
+}
+
+FileVersion BinaryInputArchive::version() const
+{
+    return myVersion;
+}
+
+std::string BinaryInputArchive::rootName()
+{
+    std::string name;
+    read(name);
+    return name;
+}
+
+uint8_t BinaryInputArchive::readByte()
+{
+    if (myPos == myEnd)
+        throw std::runtime_error("Unexpected end of binary data");
+
+    return static_cast<uint8_t>(*myPos++);
+}
+
+uint64_t BinaryInputArchive::readVarint()
+{
+    uint64_t val = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        const uint8_t byte = readByte();
+        val |= static_cast<uint64_t>(byte & 0x7f) << shift;
+
+        if (!(byte & 0x80))
+            return val;
+    }
+
+    throw std::runtime_error("Invalid variable-length integer");
+}
+
+int64_t BinaryInputArchive::readSignedVarint()
+{
+    // Undo the zigzag encoding.
+    const uint64_t val = readVarint();
+    return static_cast<int64_t>(val >> 1) ^ -static_cast<int64_t>(val & 1);
+}
+
+size_t BinaryInputArchive::readSize()
+{
+    // Every element occupies at least one byte, so this rejects corrupt sizes
+    // before attempting to allocate memory for them.
+    const uint64_t size = readVarint();
+    if (size > static_cast<uint64_t>(myEnd - myPos))
+        throw std::runtime_error("Invalid container size");
+
+    return static_cast<size_t>(size);
+}
+
+void BinaryInputArchive::read(int &val)
+{
+    val = static_cast<int>(readSignedVarint());
+}
+
+void BinaryInputArchive::read(int8_t &val)
+{
+    val = static_cast<int8_t>(readByte());
+}
+
+void BinaryInputArchive::read(unsigned int &val)
+{
+    val = static_cast<unsigned int>(readVarint());
+}
+
+void BinaryInputArchive::read(uint8_t &val)
+{
+    val = readByte();
+}
+
+void BinaryInputArchive::read(bool &val)
+{
+    val = readByte() != 0;
+}
+
+void BinaryInputArchive::read(std::string &str)
+{
+    const size_t size = readSize();
+    str.assign(myPos, size);
+    myPos += size;
+}
+
+void BinaryInputArchive::read(boost::gregorian::date &date)
+{
+    int year, month, day;
+    read(year);
+    read(month);
+    read(day);
+    date = boost::gregorian::date(year, month, day);
+}
+
+BinaryOutputArchive::BinaryOutputArchive(std::ostream &os,
+                                         FileVersion version,
+                                         const std::string &root_name)
+    : myStream(&os), myVersion(version)
+{
+    myBuffer.append(MAGIC, MAGIC_SIZE);
+    writeSignedVarint(static_cast<int>(version));
+    write(root_name);
+}
+
+BinaryOutputArchive::BinaryOutputArchive(FileVersion version)
+    : myStream(nullptr), myVersion(version)
+{
+}
+
+BinaryOutputArchive::~BinaryOutputArchive()
+{
+    if (myStream)
+        myStream->write(myBuffer.data(), myBuffer.size());
+}
+
+size_t BinaryOutputArchive::getHash() const
+{
+    return boost::hash_range(myBuffer.begin(), myBuffer.end());
+}
+
+void BinaryOutputArchive::writeVarint(uint64_t val)
+{
+    while (val >= 0x80)
+    {
+        myBuffer.push_back(static_cast<char>((val & 0x7f) | 0x80));
+        val >>= 7;
+    }
+
+    myBuffer.push_back(static_cast<char>(val));
+}
+
+void BinaryOutputArchive::writeSignedVarint(int64_t val)
+{
+    // Use a zigzag encoding so that small negative numbers are also compact.
+    writeVarint((static_cast<uint64_t>(val) << 1) ^
+                static_cast<uint64_t>(val >> 63));
+}
+
+void BinaryOutputArchive::write(int val)
+{
+    writeSignedVarint(val);
+}
+
+void BinaryOutputArchive::write(int8_t val)
+{
+    myBuffer.push_back(static_cast<char>(val));
+}
+
+void BinaryOutputArchive::write(unsigned int val)
+{
+    writeVarint(val);
+}
+
+void BinaryOutputArchive::write(uint8_t val)
+{
+    myBuffer.push_back(static_cast<char>(val));
+}
+
+void BinaryOutputArchive::write(bool val)
+{
+    myBuffer.push_back(val ? 1 : 0);
+}
+
+void BinaryOutputArchive::write(const std::string &str)
+{
+    writeVarint(str.size());
+    myBuffer.append(str);
+}
+
+void BinaryOutputArchive::write(const boost::gregorian::date &date)
+{
+    write(static_cast<int>(date.year()));
+    write(static_cast<int>(date.month()));
+    write(static_cast<int>(date.day()));
+}
+}
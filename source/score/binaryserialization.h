@@ -0,0 +1,334 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SCORE_BINARYSERIALIZATION_H
+#define SCORE_BINARYSERIALIZATION_H
+
+#include <array>
+#include <bitset>
+#include <boost/date_time/gregorian/gregorian.hpp>
+#include <boost/optional.hpp>
+#include <cstdint>
+#include "fileversion.h"
+#include <iosfwd>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ScoreUtils
+{
+/// Reads data written by BinaryOutputArchive. This is a compact alternative to
+/// the JSON format which uses the same serialize() methods, but the values
+/// are read in the order they were written rather than being looked up by
+/// name, so no document tree is built.
+class BinaryInputArchive
+{
+public:
+    static const bool IS_LOADING = true;
+
+    BinaryInputArchive(std::istream &is);
+
+    FileVersion version() const;
+
+    /// Reads the name that the top-level object was saved with.
+    std::string rootName();
+
+    template <typename T>
+    void operator()(const char *, T &obj)
+    {
+        read(obj);
+    }
+
+private:
+    uint64_t readVarint();
+    int64_t readSignedVarint();
+    /// Reads the number of elements in a container, and checks that the
+    /// number is not larger than the remaining data.
+    size_t readSize();
+    uint8_t readByte();
+
+    void read(int &val);
+    void read(int8_t &val);
+    void read(unsigned int &val);
+    void read(uint8_t &val);
+    void read(bool &val);
+    void read(std::string &str);
+
+    template <typename T>
+    void read(std::vector<T> &vec);
+
+    template <typename K, typename V, typename C>
+    void read(std::map<K, V, C> &map);
+
+    template <typename T, size_t N>
+    void read(std::array<T, N> &arr);
+
+    template <size_t N>
+    void read(std::bitset<N> &bits);
+
+    template <typename T>
+    void read(boost::optional<T> &val);
+
+    void read(boost::gregorian::date &date);
+
+    template <typename T>
+    typename std::enable_if<std::is_enum<T>::value>::type read(T &val)
+    {
+        val = static_cast<T>(readSignedVarint());
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_class<T>::value>::type read(T &obj)
+    {
+        obj.serialize(*this, myVersion);
+    }
+
+    std::string myData;
+    const char *myPos;
+    const char *myEnd;
+    FileVersion myVersion;
+};
+
+/// Returns whether the stream contains a binary archive, without consuming
+/// any data from the stream.
+bool isBinaryArchive(std::istream &is);
+
+template <typename T>
+void loadBinary(std::istream &input, const std::string &name, T &obj)
+{
+    BinaryInputArchive archive(input);
+    if (archive.version() > FileVersion::LATEST_VERSION ||
+        archive.version() < FileVersion::INITIAL_VERSION)
+    {
+        throw std::runtime_error("Invalid file version");
+    }
+
+    const std::string root_name = archive.rootName();
+    if (root_name != name)
+    {
+        throw std::runtime_error("Unexpected binary data: found " + root_name +
+                                 ", expected " + name);
+    }
+
+    archive(name.c_str(), obj);
+}
+
+/// Writes objects in a compact binary format. The data is buffered in memory
+/// and written to the stream when the archive is destroyed.
+class BinaryOutputArchive
+{
+public:
+    static const bool IS_LOADING = false;
+
+    BinaryOutputArchive(std::ostream &os, FileVersion version,
+                        const std::string &root_name);
+    /// Creates an archive that only keeps the data in memory, e.g. for
+    /// computing a hash of it.
+    explicit BinaryOutputArchive(FileVersion version);
+    ~BinaryOutputArchive();
+
+    /// Returns a hash of the data that has been written so far.
+    size_t getHash() const;
+
+    template <typename T>
+    void operator()(const char *, const T &obj)
+    {
+        write(obj);
+    }
+
+private:
+    void writeVarint(uint64_t val);
+    void writeSignedVarint(int64_t val);
+
+    void write(int val);
+    void write(int8_t val);
+    void write(unsigned int val);
+    void write(uint8_t val);
+    void write(bool val);
+    void write(const std::string &str);
+
+    template <typename T>
+    void write(const std::vector<T> &vec);
+
+    template <typename K, typename V, typename C>
+    void write(const std::map<K, V, C> &map);
+
+    template <typename T, size_t N>
+    void write(const std::array<T, N> &arr);
+
+    template <size_t N>
+    void write(const std::bitset<N> &bits);
+
+    template <typename T>
+    void write(const boost::optional<T> &val);
+
+    void write(const boost::gregorian::date &date);
+
+    template <typename T>
+    typename std::enable_if<std::is_enum<T>::value>::type write(const T &val)
+    {
+        writeSignedVarint(static_cast<int>(val));
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_class<T>::value>::type write(const T &obj)
+    {
+        const_cast<T &>(obj).serialize(*this, myVersion);
+    }
+
+    std::ostream *myStream;
+    std::string myBuffer;
+    const FileVersion myVersion;
+};
+
+template <typename T>
+void saveBinary(std::ostream &output, const std::string &name, const T &obj)
+{
+    BinaryOutputArchive ar(output, FileVersion::LATEST_VERSION, name);
+    ar(name.c_str(), obj);
+}
+
+/// Returns a hash of the object's contents, which is computed from its binary
+/// serialization. Objects with the same contents have the same hash, so this
+/// can be used to check whether an object has changed.
+template <typename T>
+size_t hashContents(const T &obj)
+{
+    BinaryOutputArchive ar(FileVersion::LATEST_VERSION);
+    ar("", obj);
+    return ar.getHash();
+}
+
+template <typename T>
+void BinaryInputArchive::read(std::vector<T> &vec)
+{
+    const size_t size = readSize();
+
+    vec.resize(size);
+    for (size_t i = 0; i < size; ++i)
+        read(vec[i]);
+}
+
+template <typename K, typename V, typename C>
+void BinaryInputArchive::read(std::map<K, V, C> &map)
+{
+    const size_t size = readSize();
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        K key;
+        read(key);
+
+        V value;
+        read(value);
+        map[key] = value;
+    }
+}
+
+template <typename T, size_t N>
+void BinaryInputArchive::read(std::array<T, N> &arr)
+{
+    for (T &val : arr)
+        read(val);
+}
+
+template <size_t N>
+void BinaryInputArchive::read(std::bitset<N> &bits)
+{
+    bits.reset();
+
+    uint8_t byte = 0;
+    for (size_t i = 0; i < N; ++i)
+    {
+        if (i % 8 == 0)
+            byte = readByte();
+
+        bits[i] = (byte >> (i % 8)) & 1;
+    }
+}
+
+template <typename T>
+void BinaryInputArchive::read(boost::optional<T> &val)
+{
+    bool has_value;
+    read(has_value);
+
+    if (!has_value)
+        val.reset();
+    else
+    {
+        T data;
+        read(data);
+        val.reset(data);
+    }
+}
+
+template <typename T>
+void BinaryOutputArchive::write(const std::vector<T> &vec)
+{
+    writeVarint(vec.size());
+    for (const T &obj : vec)
+        write(obj);
+}
+
+template <typename K, typename V, typename C>
+void BinaryOutputArchive::write(const std::map<K, V, C> &map)
+{
+    writeVarint(map.size());
+    for (const auto &pair : map)
+    {
+        write(pair.first);
+        write(pair.second);
+    }
+}
+
+template <typename T, size_t N>
+void BinaryOutputArchive::write(const std::array<T, N> &arr)
+{
+    for (const T &val : arr)
+        write(val);
+}
+
+template <size_t N>
+void BinaryOutputArchive::write(const std::bitset<N> &bits)
+{
+    uint8_t byte = 0;
+    for (size_t i = 0; i < N; ++i)
+    {
+        if (bits[i])
+            byte |= 1 << (i % 8);
+
+        if (i % 8 == 7 || i == N - 1)
+        {
+            myBuffer.push_back(static_cast<char>(byte));
+            byte = 0;
+        }
+    }
+}
+
+template <typename T>
+void BinaryOutputArchive::write(const boost::optional<T> &val)
+{
+    write(static_cast<bool>(val));
+    if (val)
+        write(*val);
+}
+}
+
+#endif
@@ -23,6 +23,7 @@ const int Score::MAX_LINE_SPACING = 14;
 Score::Score()
     : myLineSpacing(9)
 {
+    updateIndexes(0);
 }
 
 bool Score::operator==(const Score &other) const
@@ -60,11 +61,35 @@ void Score::insertSystem(const System &system, int index)
         mySystems.push_back(system);
     else
         mySystems.insert(mySystems.begin() + index, system);
+
+    updateIndexes(index < 0 ? static_cast<int>(mySystems.size()) - 1 : index);
 }
 
 void Score::removeSystem(int index)
 {
     mySystems.erase(mySystems.begin() + index);
+    updateIndexes(index);
+}
+
+const PlayerChangeIndex &Score::getPlayerChangeIndex() const
+{
+    return myPlayerChangeIndex;
+}
+
+const BarNumberIndex &Score::getBarNumberIndex() const
+{
+    return myBarNumberIndex;
+}
+
+void Score::updateIndexes(int systemIndex)
+{
+    myPlayerChangeIndex.update(*this, systemIndex);
+    myBarNumberIndex.update(*this, systemIndex);
+
+    // The view filters use the player change index, so they must be updated
+    // last.
+    for (ViewFilter &filter : myViewFilters)
+        filter.updateVisibility(*this, systemIndex);
 }
 
 boost::iterator_range<Score::PlayerIterator> Score::getPlayers()
@@ -130,11 +155,21 @@ boost::iterator_range<Score::ViewFilterConstIterator> Score::getViewFilters() co
 void Score::insertViewFilter(const ViewFilter &filter)
 {
     myViewFilters.push_back(filter);
+    updateViewFilters();
 }
 
 void Score::removeViewFilter(int index)
 {
     myViewFilters.erase(myViewFilters.begin() + index);
+    updateViewFilters();
+}
+
+void Score::updateViewFilters()
+{
+    // The filters may have been copied, which does not keep their cached
+    // visibility.
+    for (ViewFilter &filter : myViewFilters)
+        filter.updateVisibility(*this);
 }
 
 int Score::getLineSpacing() const
@@ -154,27 +189,8 @@ const PlayerChange *ScoreUtils::getCurrentPlayers(const Score &score,
                                                   int systemIndex,
                                                   int positionIndex)
 {
-    const PlayerChange *lastChange = nullptr;
-
-    int i = 0;
-    for (const System &system : score.getSystems())
-    {
-        if (i > systemIndex)
-            break;
-
-        for (const PlayerChange &change : system.getPlayerChanges())
-        {
-            if (i < systemIndex ||
-               (i == systemIndex && change.getPosition() <= positionIndex))
-            {
-                lastChange = &change;
-            }
-        }
-
-        ++i;
-    }
-
-    return lastChange;
+    return score.getPlayerChangeIndex().getCurrentPlayers(score, systemIndex,
+                                                          positionIndex);
 }
 
 void ScoreUtils::adjustRehearsalSigns(Score &score)
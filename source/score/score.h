@@ -24,6 +24,8 @@
 #include "player.h"
 #include "scoreinfo.h"
 #include "system.h"
+#include "utils/barnumberindex.h"
+#include "utils/playerchangeindex.h"
 #include "viewfilter.h"
 #include <vector>
 
@@ -62,6 +64,16 @@ public:
     /// Removes the specified system from the score.
     void removeSystem(int index);
 
+    /// Returns the index used for finding the active player change at a
+    /// location.
+    const PlayerChangeIndex &getPlayerChangeIndex() const;
+    /// Returns the index used for numbering and finding bars.
+    const BarNumberIndex &getBarNumberIndex() const;
+    /// Updates the player change index, bar numbers, and view filters after
+    /// player changes, barlines or staves are added to or removed from the
+    /// system, or after players are edited.
+    void updateIndexes(int systemIndex);
+
     /// Returns the set of players in the score.
     boost::iterator_range<PlayerIterator> getPlayers();
     /// Returns the set of players in the score.
@@ -103,6 +115,9 @@ public:
     static const int MAX_LINE_SPACING;
 
 private:
+    /// Recomputes the visibility for every view filter.
+    void updateViewFilters();
+
     // TODO - add font settings, chord diagrams, etc.
     ScoreInfo myScoreInfo;
     std::vector<System> mySystems;
@@ -110,6 +125,8 @@ private:
     std::vector<Instrument> myInstruments;
     int myLineSpacing; ///< Spacing between tab lines (in pixels).
     std::vector<ViewFilter> myViewFilters;
+    PlayerChangeIndex myPlayerChangeIndex;
+    BarNumberIndex myBarNumberIndex;
 };
 
 template <class Archive>
@@ -123,6 +140,10 @@ void Score::serialize(Archive &ar, const FileVersion version)
 
     if (version >= FileVersion::VIEW_FILTERS)
         ar("view_filters", myViewFilters);
+
+    // The systems may have been replaced when loading.
+    if (Archive::IS_LOADING)
+        updateIndexes(0);
 }
 
 namespace ScoreUtils {
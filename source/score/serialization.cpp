@@ -17,33 +17,326 @@
 
 #include "serialization.h"
 
-#include <rapidjson/error/en.h>
+#include <cctype>
+#include <istream>
 
 namespace ScoreUtils
 {
-InputArchive::InputArchive(std::istream &is) : myStream(is)
+InputArchive::InputArchive(std::istream &is)
+    : myBuffer(is.rdbuf()), myOffset(0), myAtObjectStart(false)
 {
     if (!is)
         throw std::runtime_error("Could not open stream");
 
-    myDocument.ParseStream<0>(myStream);
+    beginObject();
+    (*this)("version", myVersion);
+}
+
+FileVersion InputArchive::version() const
+{
+    return myVersion;
+}
+
+void InputArchive::finish()
+{
+    endObject();
+
+    if (peek() != '\0')
+        throw error("Unexpected data after the end of the document.");
+}
 
-    if (myDocument.HasParseError())
+std::runtime_error InputArchive::error(const std::string &msg) const
+{
+    return std::runtime_error("Parse error at offset " +
+                              std::to_string(myOffset) + ": " + msg);
+}
+
+char InputArchive::get()
+{
+    const int c = myBuffer->sbumpc();
+    if (c == std::char_traits<char>::eof())
+        throw error("The document ended unexpectedly.");
+
+    ++myOffset;
+    return static_cast<char>(c);
+}
+
+char InputArchive::peek()
+{
+    while (true)
     {
-        throw std::runtime_error("Parse error at offset " +
-                                 std::to_string(myDocument.GetErrorOffset()) +
-                                 ": " +
-                                 GetParseError_En(myDocument.GetParseError()));
+        const int c = myBuffer->sgetc();
+        if (c == std::char_traits<char>::eof())
+            return '\0';
+
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t')
+            return static_cast<char>(c);
+
+        myBuffer->sbumpc();
+        ++myOffset;
     }
+}
 
-    myIterators.push(myDocument.MemberBegin());
+void InputArchive::expect(char c)
+{
+    if (!consume(c))
+        throw error(std::string("Expected '") + c + "'.");
+}
 
-    (*this)("version", myVersion);
+bool InputArchive::consume(char c)
+{
+    if (peek() != c)
+        return false;
+
+    get();
+    return true;
 }
 
-FileVersion InputArchive::version() const
+void InputArchive::beginObject()
 {
-    return myVersion;
+    expect('{');
+    myAtObjectStart = true;
+}
+
+void InputArchive::endObject()
+{
+    while (nextMember())
+        skipValue();
+
+    expect('}');
+    // The object may have been empty, so reset the flag before continuing
+    // with the parent's members.
+    myAtObjectStart = false;
+}
+
+bool InputArchive::nextMember()
+{
+    const char c = peek();
+    if (c == '}')
+    {
+        myName = "end of object";
+        return false;
+    }
+
+    // There is no comma before the first member of the object.
+    if (!myAtObjectStart)
+        expect(',');
+    myAtObjectStart = false;
+
+    readString(myName);
+    expect(':');
+    return true;
+}
+
+bool InputArchive::findMember(const char *name)
+{
+    while (nextMember())
+    {
+        if (myName == name)
+            return true;
+
+        // Ignore any members that this object does not read.
+        skipValue();
+    }
+
+    return false;
+}
+
+bool InputArchive::nextElement(bool first)
+{
+    if (peek() == ']')
+        return false;
+
+    if (!first)
+        expect(',');
+    return true;
+}
+
+void InputArchive::readString(std::string &str)
+{
+    expect('"');
+    str.clear();
+
+    while (true)
+    {
+        char c = get();
+        if (c == '"')
+            return;
+        else if (c != '\\')
+        {
+            str.push_back(c);
+            continue;
+        }
+
+        c = get();
+        switch (c)
+        {
+        case '"':
+        case '\\':
+        case '/':
+            str.push_back(c);
+            break;
+        case 'b':
+            str.push_back('\b');
+            break;
+        case 'f':
+            str.push_back('\f');
+            break;
+        case 'n':
+            str.push_back('\n');
+            break;
+        case 'r':
+            str.push_back('\r');
+            break;
+        case 't':
+            str.push_back('\t');
+            break;
+        case 'u':
+        {
+            auto read_hex = [this]() {
+                unsigned int code = 0;
+                for (int i = 0; i < 4; ++i)
+                {
+                    const char digit = get();
+                    code <<= 4;
+                    if (digit >= '0' && digit <= '9')
+                        code |= digit - '0';
+                    else if (digit >= 'a' && digit <= 'f')
+                        code |= digit - 'a' + 10;
+                    else if (digit >= 'A' && digit <= 'F')
+                        code |= digit - 'A' + 10;
+                    else
+                        throw error("Invalid unicode escape sequence.");
+                }
+                return code;
+            };
+
+            unsigned int code = read_hex();
+
+            // Combine surrogate pairs.
+            if (code >= 0xD800 && code <= 0xDBFF)
+            {
+                if (get() != '\\' || get() != 'u')
+                    throw error("Invalid unicode surrogate pair.");
+
+                const unsigned int low = read_hex();
+                if (low < 0xDC00 || low > 0xDFFF)
+                    throw error("Invalid unicode surrogate pair.");
+
+                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+            }
+            else if (code >= 0xDC00 && code <= 0xDFFF)
+                throw error("Invalid unicode surrogate pair.");
+
+            // Encode as UTF-8.
+            if (code < 0x80)
+                str.push_back(static_cast<char>(code));
+            else if (code < 0x800)
+            {
+                str.push_back(static_cast<char>(0xC0 | (code >> 6)));
+                str.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            }
+            else if (code < 0x10000)
+            {
+                str.push_back(static_cast<char>(0xE0 | (code >> 12)));
+                str.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                str.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            }
+            else
+            {
+                str.push_back(static_cast<char>(0xF0 | (code >> 18)));
+                str.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+                str.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                str.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            }
+            break;
+        }
+        default:
+            throw error("Invalid escape character in string.");
+        }
+    }
+}
+
+long long InputArchive::readInteger()
+{
+    const bool negative = (peek() == '-');
+    if (negative)
+        get();
+
+    if (!std::isdigit(static_cast<unsigned char>(peek())))
+        throw error("Expected an integer.");
+
+    long long val = 0;
+    while (std::isdigit(static_cast<unsigned char>(myBuffer->sgetc())))
+    {
+        val = val * 10 + (get() - '0');
+        if (val > std::numeric_limits<unsigned int>::max())
+            throw std::overflow_error("Invalid integer value");
+    }
+
+    const char c = static_cast<char>(myBuffer->sgetc());
+    if (c == '.' || c == 'e' || c == 'E')
+        throw error("Expected an integer.");
+
+    return negative ? -val : val;
+}
+
+void InputArchive::readLiteral(const char *literal)
+{
+    for (const char *c = literal; *c; ++c)
+    {
+        if (get() != *c)
+            throw error(std::string("Expected '") + literal + "'.");
+    }
+}
+
+void InputArchive::skipValue()
+{
+    switch (peek())
+    {
+    case '{':
+        beginObject();
+        endObject();
+        break;
+    case '[':
+        expect('[');
+        for (bool first = true; nextElement(first); first = false)
+            skipValue();
+        expect(']');
+        break;
+    case '"':
+        readString(myScratch);
+        break;
+    case 't':
+        readLiteral("true");
+        break;
+    case 'f':
+        readLiteral("false");
+        break;
+    case 'n':
+        readLiteral("null");
+        break;
+    default:
+    {
+        // Skip a number, which may not be an integer.
+        if (peek() != '-' && !std::isdigit(static_cast<unsigned char>(peek())))
+            throw error("Unexpected character.");
+
+        get();
+        while (true)
+        {
+            const int c = myBuffer->sgetc();
+            if (c == std::char_traits<char>::eof() ||
+                !(std::isdigit(c) || c == '.' || c == 'e' || c == 'E' ||
+                  c == '+' || c == '-'))
+            {
+                break;
+            }
+            get();
+        }
+        break;
+    }
+    }
 }
 
 OutputArchive::OutputArchive(std::ostream &os, FileVersion version)
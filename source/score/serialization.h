@@ -22,97 +22,78 @@
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/optional.hpp>
-#include <boost/variant.hpp>
 #include <bitset>
+#include <cstdio>
 #include "fileversion.h"
+#include <limits>
 #include <map>
-#include <rapidjson/document.h>
 #include <rapidjson/prettywriter.h>
-#include <stack>
 #include <stdexcept>
 #include <util/rapidjson_iostreams.h>
 #include <vector>
 
 namespace ScoreUtils
 {
+/// Reads the JSON data one token at a time, and deserializes the values
+/// directly into the objects rather than first building a document tree.
 class InputArchive
 {
 public:
+    /// Whether objects are being loaded, rather than saved.
+    static const bool IS_LOADING = true;
+
     InputArchive(std::istream &is);
 
     FileVersion version() const;
 
+    /// Consumes the end of the top-level object, which must also be the end
+    /// of the document.
+    void finish();
+
     template <typename T>
-    void operator()(const std::string &expectedName, T &obj)
+    void operator()(const char *expectedName, T &obj)
     {
-        if (expectedName != name())
+        if (!findMember(expectedName))
         {
             throw std::runtime_error(
                 std::string("Unexpected or missing JSON data: found ") +
-                name() + ", expected " + expectedName);
+                myName + ", expected " + expectedName);
         }
 
         read(obj);
-        advance();
     }
 
 private:
-    typedef rapidjson::GenericValue<rapidjson::UTF8<> > JSONValue;
-
-    struct ValueVisitor : public boost::static_visitor<const JSONValue &>
-    {
-        const JSONValue &operator()(
-            const JSONValue::ConstMemberIterator &it) const
-        {
-            return it->value;
-        }
-
-        const JSONValue &operator()(
-            const JSONValue::ConstValueIterator &it) const
-        {
-            return *it;
-        }
-    };
-
-    struct NameVisitor : public boost::static_visitor<std::string>
-    {
-        std::string operator()(const JSONValue::ConstMemberIterator &it) const
-        {
-            return it->name.GetString();
-        }
-
-        std::string operator()(const JSONValue::ConstValueIterator &) const
-        {
-            throw std::logic_error("Cannot read the name of an array element");
-        }
-    };
-
-    struct AdvanceVisitor : public boost::static_visitor<void>
-    {
-        template <typename Iterator>
-        void operator()(Iterator &it) const
-        {
-            ++it;
-        }
-    };
-
-    void advance()
-    {
-        AdvanceVisitor visitor;
-        myIterators.top().apply_visitor(visitor);
-    }
-
-    std::string name() const
-    {
-        NameVisitor visitor;
-        return myIterators.top().apply_visitor(visitor);
-    }
-
-    const JSONValue &value() const
-    {
-        ValueVisitor visitor;
-        return myIterators.top().apply_visitor(visitor);
-    }
+    /// Advances to the next member of the current object and reads its name,
+    /// or returns false at the end of the object.
+    bool nextMember();
+    /// Advances to the member with the given name, skipping any unknown
+    /// members before it. Returns false if the end of the object is reached.
+    bool findMember(const char *name);
+    /// Returns the next character after any whitespace, without consuming
+    /// it.
+    char peek();
+    /// Consumes the next character, which must be the given character.
+    void expect(char c);
+    /// Consumes the next character if it is the given character.
+    bool consume(char c);
+    char get();
+
+    void readString(std::string &str);
+    long long readInteger();
+    void readLiteral(const char *literal);
+    void skipValue();
+
+    void beginObject();
+    /// Skips any remaining members that were not read, and consumes the end
+    /// of the object.
+    void endObject();
+
+    /// Returns whether there is another element in the current array.
+    bool nextElement(bool first);
+
+    /// Creates an exception for a parse error at the current offset.
+    std::runtime_error error(const std::string &msg) const;
 
     inline void read(int &val);
     inline void read(int8_t &val);
@@ -141,25 +122,29 @@ private:
     template <typename T>
     typename std::enable_if<std::is_enum<T>::value>::type read(T &val)
     {
-        val = static_cast<T>(value().GetInt());
+        int int_val;
+        read(int_val);
+        val = static_cast<T>(int_val);
     }
 
     template <typename T>
     typename std::enable_if<std::is_class<T>::value>::type read(T &obj)
     {
-        myIterators.push(value().MemberBegin());
+        beginObject();
         obj.serialize(*this, myVersion);
-        myIterators.pop();
+        endObject();
     }
 
-    Util::RapidJSON::IStreamWrapper myStream;
-    rapidjson::Document myDocument;
+    std::streambuf *myBuffer;
+    size_t myOffset;
+    /// Whether no members of the current object have been read yet.
+    bool myAtObjectStart;
     FileVersion myVersion;
-
-	// Iterate over both objects and arrays in a uniform manner.
-    typedef boost::variant<JSONValue::ConstMemberIterator,
-                           JSONValue::ConstValueIterator> Iterator;
-    std::stack<Iterator> myIterators;
+    /// The name of the current object member. This is reused to avoid
+    /// allocating memory for every member.
+    std::string myName;
+    /// Storage for skipped strings.
+    std::string myScratch;
 };
 
 template <typename T>
@@ -172,12 +157,15 @@ void load(std::istream &input, const std::string &name, T &obj)
         throw std::runtime_error("Invalid file version");
     }
 
-    archive(name, obj);
+    archive(name.c_str(), obj);
+    archive.finish();
 }
 
 class OutputArchive
 {
 public:
+    static const bool IS_LOADING = false;
+
     OutputArchive(std::ostream &os, FileVersion version);
     ~OutputArchive();
 
@@ -239,12 +227,19 @@ void save(std::ostream &output, const std::string &name, const T &obj)
 
 void InputArchive::read(int &val)
 {
-    val = value().GetInt();
+    const long long int_val = readInteger();
+    if (int_val > std::numeric_limits<int>::max() ||
+        int_val < std::numeric_limits<int>::min())
+    {
+        throw std::overflow_error("Invalid int value");
+    }
+    val = static_cast<int>(int_val);
 }
 
 void InputArchive::read(int8_t &val)
 {
-    int int_val = value().GetInt();
+    int int_val;
+    read(int_val);
     if (int_val > std::numeric_limits<int8_t>::max())
         throw std::overflow_error("Invalid int8_t value");
     val = static_cast<int8_t>(int_val);
@@ -252,12 +247,16 @@ void InputArchive::read(int8_t &val)
 
 void InputArchive::read(unsigned int &val)
 {
-    val = value().GetUint();
+    const long long int_val = readInteger();
+    if (int_val > std::numeric_limits<unsigned int>::max() || int_val < 0)
+        throw std::overflow_error("Invalid unsigned int value");
+    val = static_cast<unsigned int>(int_val);
 }
 
 void InputArchive::read(uint8_t &val)
 {
-    unsigned int uint_val = value().GetUint();
+    unsigned int uint_val;
+    read(uint_val);
     if (uint_val > std::numeric_limits<uint8_t>::max())
         throw std::overflow_error("Invalid uint8_t value");
     val = static_cast<uint8_t>(uint_val);
@@ -265,75 +264,84 @@ void InputArchive::read(uint8_t &val)
 
 void InputArchive::read(bool &val)
 {
-    val = value().GetBool();
+    if (peek() == 't')
+    {
+        readLiteral("true");
+        val = true;
+    }
+    else
+    {
+        readLiteral("false");
+        val = false;
+    }
 }
 
 void InputArchive::read(std::string &str)
 {
-    str = value().GetString();
+    readString(str);
 }
 
 template <typename T>
 void InputArchive::read(std::vector<T> &vec)
 {
-    auto size = value().Size();
-    myIterators.push(value().Begin());
+    vec.clear();
 
-    vec.resize(size);
-    for (unsigned int i = 0; i < size; ++i)
+    expect('[');
+    while (nextElement(vec.empty()))
     {
-        read(vec[i]);
-        advance();
+        vec.emplace_back();
+        read(vec.back());
     }
-
-    myIterators.pop();
+    expect(']');
 }
 
 template <typename K, typename V, typename C>
 void InputArchive::read(std::map<K, V, C> &map)
 {
-    auto it = value().MemberBegin();
-    const long long size = std::distance(it, value().MemberEnd());
-    myIterators.push(it);
+    beginObject();
 
-    for (long long i = 0; i < size; ++i)
+    while (nextMember())
     {
-        const K key = boost::lexical_cast<K>(name());
+        const K key = boost::lexical_cast<K>(myName);
 
         V value;
         read(value);
         map[key] = value;
-
-        advance();
     }
 
-    myIterators.pop();
+    endObject();
 }
 
 template <typename T, size_t N>
 void InputArchive::read(std::array<T, N> &arr)
 {
-    myIterators.push(value().MemberBegin());
+    beginObject();
 
+    char name[16];
     for (size_t i = 0; i < N; ++i)
-        (*this)(std::to_string(i), arr[i]);
+    {
+        std::snprintf(name, sizeof(name), "%u", static_cast<unsigned int>(i));
+        (*this)(name, arr[i]);
+    }
 
-    myIterators.pop();
+    endObject();
 }
 
 template <size_t N>
 void InputArchive::read(std::bitset<N> &bits)
 {
-    std::string data;
-    read(data);
-    bits = std::bitset<N>(data);
+    read(myScratch);
+    bits = std::bitset<N>(myScratch);
 }
 
 template <typename T>
 void InputArchive::read(boost::optional<T> &val)
 {
-    if (value().IsNull())
+    if (peek() == 'n')
+    {
+        readLiteral("null");
         val.reset();
+    }
     else
     {
         T data;
@@ -344,9 +352,8 @@ void InputArchive::read(boost::optional<T> &val)
 
 void InputArchive::read(boost::gregorian::date &date)
 {
-    std::string date_str;
-    read(date_str);
-    date = boost::gregorian::from_undelimited_string(date_str);
+    read(myScratch);
+    date = boost::gregorian::from_undelimited_string(myScratch);
 }
 
 void OutputArchive::write(int val)
@@ -21,35 +21,64 @@
 #include <algorithm>
 #include <boost/range/adaptor/filtered.hpp>
 #include <boost/range/iterator_range_core.hpp>
+#include <cassert>
+#include <iterator>
+#include <vector>
 
 namespace ScoreUtils {
 
-    /// Returns the object at the given position index, or null.
+    /// Sorts objects by their positions in the system.
     template <typename T>
-    typename T::pointer findByPosition(const boost::iterator_range<T> &range,
-                                       int position)
+    struct OrderByPosition
+    {
+        bool operator()(const T &obj1, const T &obj2) const
+        {
+            return obj1.getPosition() < obj2.getPosition();
+        }
+    };
+
+    /// Compares an object's position to a position index.
+    struct PositionLessThan
     {
-        size_t n = range.size();
-        for (size_t i = 0; i < n; ++i)
+        template <typename T>
+        bool operator()(const T &obj, int position) const
         {
-            if (range[i].getPosition() == position)
-                return &range[i];
+            return obj.getPosition() < position;
         }
+    };
 
-        return nullptr;
+    /// Returns whether the objects are sorted by position. insertObject()
+    /// maintains this, and the lookup functions below rely on it.
+    template <typename T>
+    bool isSortedByPosition(const boost::iterator_range<T> &range)
+    {
+        typedef typename std::iterator_traits<T>::value_type ValueType;
+        return std::is_sorted(range.begin(), range.end(),
+                              OrderByPosition<ValueType>());
     }
 
+    /// Returns the index of the first object at the given position index, or
+    /// -1.
     template <typename T>
     int findIndexByPosition(const boost::iterator_range<T> &range, int position)
     {
-        const int n = static_cast<int>(range.size());
-        for (int i = 0; i < n; ++i)
-        {
-            if (range[i].getPosition() == position)
-                return i;
-        }
+        assert(isSortedByPosition(range));
 
-        return -1;
+        auto it = std::lower_bound(range.begin(), range.end(), position,
+                                   PositionLessThan());
+        if (it == range.end() || it->getPosition() != position)
+            return -1;
+
+        return static_cast<int>(it - range.begin());
+    }
+
+    /// Returns the object at the given position index, or null.
+    template <typename T>
+    typename T::pointer findByPosition(const boost::iterator_range<T> &range,
+                                       int position)
+    {
+        const int index = findIndexByPosition(range, position);
+        return index < 0 ? nullptr : &range[index];
     }
 
     struct InPositionRange
@@ -80,28 +109,15 @@ namespace ScoreUtils {
 
     // Some helper methods to reduce code duplication.
 
-    /// Sorts objects by their positions in the system.
-    template <typename T>
-    struct OrderByPosition
-    {
-        bool operator()(const T &obj1, const T &obj2) const
-        {
-            return obj1.getPosition() < obj2.getPosition();
-        }
-    };
-
     template <typename T>
     void insertObject(std::vector<T> &objects, const T &obj)
     {
-        // Avoid sorting unless we actually need to. This improves performance
-        // quite a bit when, for example, we are importing from other file
-        // formats and inserting objects in order.
-        const bool needsSort = !objects.empty() &&
-                objects.back().getPosition() > obj.getPosition();
-
-        objects.push_back(obj);
-        if (needsSort)
-            std::sort(objects.begin(), objects.end(), OrderByPosition<T>());
+        // Insert after any objects at the same position, which is just an
+        // append when, for example, we are importing from other file formats
+        // and inserting objects in order.
+        objects.insert(std::upper_bound(objects.begin(), objects.end(), obj,
+                                        OrderByPosition<T>()),
+                       obj);
     }
 
     template <typename T>
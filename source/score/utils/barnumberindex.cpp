@@ -0,0 +1,67 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "barnumberindex.h"
+
+#include <algorithm>
+#include <score/score.h>
+#include <stdexcept>
+
+void BarNumberIndex::update(const Score &score, int systemIndex)
+{
+    const int numSystems = static_cast<int>(score.getSystems().size());
+    myFirstBars.resize(numSystems + 1);
+
+    for (int i = std::max(systemIndex, 0); i <= numSystems; ++i)
+    {
+        if (i == 0)
+            myFirstBars[i] = 1;
+        else
+        {
+            // Don't count the end bar of the system.
+            const System &system = score.getSystems()[i - 1];
+            myFirstBars[i] = myFirstBars[i - 1] +
+                             static_cast<int>(system.getBarlines().size()) - 1;
+        }
+    }
+}
+
+int BarNumberIndex::getFirstBarNumber(int systemIndex) const
+{
+    return myFirstBars.at(systemIndex);
+}
+
+int BarNumberIndex::getNumBars() const
+{
+    return myFirstBars.back() - 1;
+}
+
+SystemLocation BarNumberIndex::findBar(const Score &score,
+                                       int barNumber) const
+{
+    if (barNumber < 1 || barNumber > getNumBars())
+        throw std::out_of_range("Invalid bar number");
+
+    // Find the last system that starts at or before the bar.
+    auto it = std::upper_bound(myFirstBars.begin(), myFirstBars.end(),
+                               barNumber) - 1;
+    const int systemIndex = static_cast<int>(it - myFirstBars.begin());
+
+    const System &system = score.getSystems()[systemIndex];
+    const Barline &barline = system.getBarlines()[barNumber - *it];
+    return SystemLocation(systemIndex, barline.getPosition());
+}
@@ -0,0 +1,51 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SCORE_UTILS_BARNUMBERINDEX_H
+#define SCORE_UTILS_BARNUMBERINDEX_H
+
+#include <score/systemlocation.h>
+#include <vector>
+
+class Score;
+
+/// Stores the number of the first bar in each system, so that bars can be
+/// numbered or found without counting the barlines in every preceding system.
+/// This must be updated when systems or barlines are inserted or removed.
+class BarNumberIndex
+{
+public:
+    /// Updates the index for the given system and all following systems.
+    void update(const Score &score, int systemIndex = 0);
+
+    /// Returns the number of the first bar in the system, starting from 1.
+    int getFirstBarNumber(int systemIndex) const;
+
+    /// Returns the total number of bars in the score.
+    int getNumBars() const;
+
+    /// Returns the location of the start of the given bar.
+    /// @throw std::out_of_range if the bar number is invalid.
+    SystemLocation findBar(const Score &score, int barNumber) const;
+
+private:
+    /// The number of the first bar in each system. The final entry is one past
+    /// the last bar of the score.
+    std::vector<int> myFirstBars;
+};
+
+#endif
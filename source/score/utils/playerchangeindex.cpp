@@ -0,0 +1,85 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "playerchangeindex.h"
+
+#include <algorithm>
+#include <cassert>
+#include <score/score.h>
+
+void PlayerChangeIndex::update(const Score &score, int systemIndex)
+{
+    const int numSystems = static_cast<int>(score.getSystems().size());
+    myPrevSystems.resize(numSystems + 1);
+
+    for (int i = std::max(systemIndex, 0); i <= numSystems; ++i)
+    {
+        if (i == 0)
+            myPrevSystems[i] = -1;
+        else if (!score.getSystems()[i - 1].getPlayerChanges().empty())
+            myPrevSystems[i] = i - 1;
+        else
+            myPrevSystems[i] = myPrevSystems[i - 1];
+    }
+}
+
+const PlayerChange *PlayerChangeIndex::getCurrentPlayers(
+    const Score &score, int systemIndex, int positionIndex) const
+{
+    const int numSystems = static_cast<int>(score.getSystems().size());
+
+    // Look for a player change earlier in the same system.
+    if (systemIndex < numSystems)
+    {
+        auto changes = score.getSystems()[systemIndex].getPlayerChanges();
+        auto it = std::upper_bound(
+            changes.begin(), changes.end(), positionIndex,
+            [](int position, const PlayerChange &change) {
+                return position < change.getPosition();
+            });
+
+        if (it != changes.begin())
+            return &*(it - 1);
+    }
+
+    // Otherwise, use the last player change from a previous system.
+    const int index = std::min(systemIndex, numSystems);
+    if (myPrevSystems.size() == static_cast<size_t>(numSystems) + 1)
+    {
+        const int prevSystem = myPrevSystems[index];
+        if (prevSystem < 0)
+            return nullptr;
+
+        if (prevSystem < index &&
+            !score.getSystems()[prevSystem].getPlayerChanges().empty())
+        {
+            return &score.getSystems()[prevSystem].getPlayerChanges().back();
+        }
+    }
+
+    // The index was not updated after the score was modified. Fall back to
+    // searching the previous systems.
+    assert(false);
+    for (int i = index - 1; i >= 0; --i)
+    {
+        auto changes = score.getSystems()[i].getPlayerChanges();
+        if (!changes.empty())
+            return &changes.back();
+    }
+
+    return nullptr;
+}
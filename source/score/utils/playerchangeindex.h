@@ -0,0 +1,47 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SCORE_UTILS_PLAYERCHANGEINDEX_H
+#define SCORE_UTILS_PLAYERCHANGEINDEX_H
+
+#include <vector>
+
+class PlayerChange;
+class Score;
+
+/// Finds the active player change at any location in the score with a binary
+/// search. The index only records which systems contain player changes, so it
+/// must be updated when a system is inserted or removed, or when the first
+/// player change is added to (or the last is removed from) a system.
+class PlayerChangeIndex
+{
+public:
+    /// Updates the index for the given system and all following systems.
+    void update(const Score &score, int systemIndex = 0);
+
+    /// Returns the player change that is active at the given location, or
+    /// null if there is no player change before that location.
+    const PlayerChange *getCurrentPlayers(const Score &score, int systemIndex,
+                                          int positionIndex) const;
+
+private:
+    /// For each system, the index of the last preceding system that contains
+    /// a player change, or -1. The final entry is for the end of the score.
+    std::vector<int> myPrevSystems;
+};
+
+#endif
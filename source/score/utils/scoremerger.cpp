@@ -527,6 +527,7 @@ static void mergePlayerChanges(ScoreLocation &dest_loc,
             change.setPosition(dest_loc.getPositionIndex());
 
         dest_system.insertPlayerChange(change);
+        dest_loc.getScore().updateIndexes(dest_loc.getSystemIndex());
     }
 }
 
@@ -733,6 +734,9 @@ static void combineScores(Score &dest_score, Score &guitar_score,
         else
             dest_caret.moveToPosition(next_bar_pos);
     }
+
+    // Barlines were added to the systems after they were inserted.
+    dest_score.updateIndexes(0);
 }
 
 /// Merge the expanded bars from a multi-bar rest.
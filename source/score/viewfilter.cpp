@@ -17,6 +17,7 @@
 
 #include "viewfilter.h"
 
+#include <algorithm>
 #include <score/score.h>
 
 FilterRule::FilterRule()
@@ -114,6 +115,19 @@ ViewFilter::ViewFilter()
 {
 }
 
+ViewFilter::ViewFilter(const ViewFilter &other)
+    : myDescription(other.myDescription), myRules(other.myRules)
+{
+}
+
+ViewFilter &ViewFilter::operator=(const ViewFilter &other)
+{
+    myDescription = other.myDescription;
+    myRules = other.myRules;
+    myVisibleStaves.clear();
+    return *this;
+}
+
 bool ViewFilter::operator==(const ViewFilter &other) const
 {
     return myDescription == other.myDescription && myRules == other.myRules;
@@ -132,16 +146,19 @@ void ViewFilter::setDescription(const std::string &description)
 void ViewFilter::addRule(const FilterRule &rule)
 {
     myRules.push_back(rule);
+    myVisibleStaves.clear();
 }
 
 void ViewFilter::removeRule(int index)
 {
     myRules.erase(myRules.begin() + index);
+    myVisibleStaves.clear();
 }
 
-boost::iterator_range<ViewFilter::RuleIterator> ViewFilter::getRules()
+void ViewFilter::setRule(int index, const FilterRule &rule)
 {
-    return boost::make_iterator_range(myRules);
+    myRules[index] = rule;
+    myVisibleStaves.clear();
 }
 
 boost::iterator_range<ViewFilter::RuleConstIterator>
@@ -152,6 +169,39 @@ ViewFilter::getRules() const
 
 bool ViewFilter::accept(const Score &score, int system_index,
                         int staff_index) const
+{
+    if (system_index < static_cast<int>(myVisibleStaves.size()))
+    {
+        const std::vector<bool> &staves = myVisibleStaves[system_index];
+        if (staff_index < static_cast<int>(staves.size()))
+            return staves[staff_index];
+    }
+
+    return evaluate(score, system_index, staff_index);
+}
+
+void ViewFilter::updateVisibility(const Score &score, int system_index)
+{
+    // Start from scratch if the rules have changed.
+    if (myVisibleStaves.empty())
+        system_index = 0;
+
+    myVisibleStaves.resize(score.getSystems().size());
+
+    for (int i = std::max(system_index, 0);
+         i < static_cast<int>(myVisibleStaves.size()); ++i)
+    {
+        const System &system = score.getSystems()[i];
+        std::vector<bool> &staves = myVisibleStaves[i];
+        staves.resize(system.getStaves().size());
+
+        for (int j = 0; j < static_cast<int>(staves.size()); ++j)
+            staves[j] = evaluate(score, i, j);
+    }
+}
+
+bool ViewFilter::evaluate(const Score &score, int system_index,
+                          int staff_index) const
 {
     if (myRules.empty())
         return true;
@@ -80,10 +80,13 @@ private:
 class ViewFilter
 {
 public:
-    typedef std::vector<FilterRule>::iterator RuleIterator;
     typedef std::vector<FilterRule>::const_iterator RuleConstIterator;
 
     ViewFilter();
+    /// Copies the description and rules. The cached visibility is not copied,
+    /// since it is only valid for the score that computed it.
+    ViewFilter(const ViewFilter &other);
+    ViewFilter &operator=(const ViewFilter &other);
     bool operator==(const ViewFilter &other) const;
 
     template <class Archive>
@@ -98,18 +101,32 @@ public:
     void addRule(const FilterRule &rule);
     /// Removes the specified rule from the filter.
     void removeRule(int index);
+    /// Replaces the specified rule.
+    void setRule(int index, const FilterRule &rule);
 
-    /// Returns the list of rules in the filter.
-    boost::iterator_range<RuleIterator> getRules();
     /// Returns the list of rules in the filter.
     boost::iterator_range<RuleConstIterator> getRules() const;
 
-    /// Returns whether the given staff is visible.
+    /// Returns whether the given staff is visible. This is a quick lookup if
+    /// the score that owns the filter has called updateVisibility().
     bool accept(const Score &score, int system_index, int staff_index) const;
 
+    /// Evaluates the filter's rules for every staff in the score, starting
+    /// from the given system. The score that owns the filter calls this
+    /// whenever the players, player changes, or staves might have changed.
+    void updateVisibility(const Score &score, int system_index = 0);
+
 private:
+    /// Evaluates the rules to determine whether the given staff is visible.
+    bool evaluate(const Score &score, int system_index, int staff_index) const;
+
     std::string myDescription;
     std::vector<FilterRule> myRules;
+
+    /// Whether each staff in each system of the owning score is visible. This
+    /// is empty if the visibility has not been computed since the rules
+    /// changed.
+    std::vector<std::vector<bool>> myVisibleStaves;
 };
 
 template <class Archive>
@@ -122,6 +139,7 @@ void FilterRule::serialize(Archive &ar, const FileVersion /*version*/)
     {
     case PLAYER_NAME:
         ar("value", myStrValue);
+        myRegex = boost::regex(myStrValue);
         break;
     case NUM_STRINGS:
         ar("value", myIntValue);
@@ -137,6 +155,9 @@ void ViewFilter::serialize(Archive &ar, const FileVersion /*version*/)
 {
     ar("description", myDescription);
     ar("rules", myRules);
+
+    if (Archive::IS_LOADING)
+        myVisibleStaves.clear();
 }
 
 #endif
@@ -25,6 +25,7 @@ TEST_CASE("Actions/AddBarline", "")
     Score score;
     System system;
     score.insertSystem(system);
+    score.insertSystem(system);
 
     ScoreLocation location(score, 0, 0, 6);
     Barline barline(6, Barline::SingleBar);
@@ -33,7 +34,9 @@ TEST_CASE("Actions/AddBarline", "")
     action.redo();
     REQUIRE(location.getSystem().getBarlines().size() == 3);
     REQUIRE(location.getSystem().getBarlines()[1] == barline);
+    REQUIRE(score.getBarNumberIndex().getFirstBarNumber(1) == 3);
 
     action.undo();
     REQUIRE(location.getSystem().getBarlines().size() == 2);
+    REQUIRE(score.getBarNumberIndex().getFirstBarNumber(1) == 2);
 }
@@ -26,6 +26,7 @@ TEST_CASE("Actions/AddPlayerChange", "")
     Score score;
     System system;
     score.insertSystem(system);
+    score.insertSystem(system);
     PlayerChange change;
     change.insertActivePlayer(1, ActivePlayer(0, 2));
 
@@ -34,7 +35,10 @@ TEST_CASE("Actions/AddPlayerChange", "")
     action.redo();
     REQUIRE(score.getSystems()[0].getPlayerChanges().size() == 1);
     REQUIRE(score.getSystems()[0].getPlayerChanges()[0].getPosition() == 3);
+    REQUIRE(ScoreUtils::getCurrentPlayers(score, 1, 0) ==
+            &score.getSystems()[0].getPlayerChanges()[0]);
 
     action.undo();
     REQUIRE(score.getSystems()[0].getPlayerChanges().size() == 0);
+    REQUIRE(!ScoreUtils::getCurrentPlayers(score, 1, 0));
 }
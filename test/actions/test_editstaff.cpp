@@ -52,3 +52,46 @@ TEST_CASE("Actions/EditStaff", "")
     REQUIRE(system.getPlayerChanges()[1].getActivePlayers(0).size() == 1);
     REQUIRE(next_system.getPlayerChanges().empty());
 }
+
+TEST_CASE("Actions/EditStaff/ViewFilter", "")
+{
+    Score score;
+    Player player1;
+    player1.setDescription("Player 1");
+    Player player2;
+    player2.setDescription("Player 2");
+    score.insertPlayer(player1);
+    score.insertPlayer(player2);
+    score.insertInstrument(Instrument());
+
+    // The first staff is only used by the second player.
+    PlayerChange change;
+    change.insertActivePlayer(0, ActivePlayer(1, 0));
+    change.insertActivePlayer(1, ActivePlayer(0, 0));
+    System system;
+    system.insertPlayerChange(change);
+    system.insertStaff(Staff(6));
+    system.insertStaff(Staff(6));
+    score.insertSystem(system);
+
+    ViewFilter filter;
+    filter.addRule(FilterRule(FilterRule::PLAYER_NAME, "Player 1"));
+    score.insertViewFilter(filter);
+    const ViewFilter &cached_filter = score.getViewFilters()[0];
+
+    REQUIRE(!cached_filter.accept(score, 0, 0));
+    REQUIRE(cached_filter.accept(score, 0, 1));
+
+    ScoreLocation location(score, 0, 0);
+    EditStaff action(location, Staff::TrebleClef, 7);
+
+    // Changing the number of strings removes the players from the staff, so
+    // it is now visible.
+    action.redo();
+    REQUIRE(cached_filter.accept(score, 0, 0));
+    REQUIRE(cached_filter.accept(score, 0, 1));
+
+    action.undo();
+    REQUIRE(!cached_filter.accept(score, 0, 0));
+    REQUIRE(cached_filter.accept(score, 0, 1));
+}
@@ -30,13 +30,16 @@ TEST_CASE("Actions/RemoveBarline", "")
     Barline barline(6, Barline::SingleBar);
     system.insertBarline(barline);
     score.insertSystem(system);
+    score.insertSystem(System());
 
     RemoveBarline action(location);
 
     action.redo();
     REQUIRE(location.getSystem().getBarlines().size() == 2);
+    REQUIRE(score.getBarNumberIndex().getFirstBarNumber(1) == 2);
 
     action.undo();
     REQUIRE(location.getSystem().getBarlines().size() == 3);
+    REQUIRE(score.getBarNumberIndex().getFirstBarNumber(1) == 3);
     REQUIRE(location.getSystem().getBarlines()[1] == barline);
 }
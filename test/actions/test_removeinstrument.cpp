@@ -63,3 +63,46 @@ TEST_CASE("Actions/RemoveInstrument", "")
         REQUIRE(newChange.getActivePlayers(0)[1].getInstrumentNumber() == 1);
     }
 }
+
+TEST_CASE("Actions/RemoveInstrument/ViewFilter", "")
+{
+    Score score;
+    Player player1;
+    player1.setDescription("Player 1");
+    Player player2;
+    player2.setDescription("Player 2");
+    score.insertPlayer(player1);
+    score.insertPlayer(player2);
+    score.insertInstrument(Instrument());
+    score.insertInstrument(Instrument());
+
+    // The second staff is only used by the second player, with the
+    // instrument that is removed.
+    PlayerChange change;
+    change.insertActivePlayer(0, ActivePlayer(0, 1));
+    change.insertActivePlayer(1, ActivePlayer(1, 0));
+    System system;
+    system.insertPlayerChange(change);
+    system.insertStaff(Staff());
+    system.insertStaff(Staff());
+    score.insertSystem(system);
+
+    ViewFilter filter;
+    filter.addRule(FilterRule(FilterRule::PLAYER_NAME, "Player 1"));
+    score.insertViewFilter(filter);
+    const ViewFilter &cached_filter = score.getViewFilters()[0];
+
+    REQUIRE(cached_filter.accept(score, 0, 0));
+    REQUIRE(!cached_filter.accept(score, 0, 1));
+
+    RemoveInstrument action(score, 0);
+
+    // The second staff no longer has any players, so it is visible.
+    action.redo();
+    REQUIRE(cached_filter.accept(score, 0, 0));
+    REQUIRE(cached_filter.accept(score, 0, 1));
+
+    action.undo();
+    REQUIRE(cached_filter.accept(score, 0, 0));
+    REQUIRE(!cached_filter.accept(score, 0, 1));
+}
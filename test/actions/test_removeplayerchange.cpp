@@ -29,13 +29,16 @@ TEST_CASE("Actions/RemovePlayerChange", "")
     change.insertActivePlayer(1, ActivePlayer(0, 2));
     system.insertPlayerChange(change);
     score.insertSystem(system);
+    score.insertSystem(System());
 
     RemovePlayerChange action(ScoreLocation(score, 0, 0, 5));
 
     action.redo();
     REQUIRE(score.getSystems()[0].getPlayerChanges().size() == 0);
+    REQUIRE(!ScoreUtils::getCurrentPlayers(score, 1, 0));
 
     action.undo();
     REQUIRE(score.getSystems()[0].getPlayerChanges().size() == 1);
     REQUIRE(score.getSystems()[0].getPlayerChanges()[0] == change);
+    REQUIRE(*ScoreUtils::getCurrentPlayers(score, 1, 0) == change);
 }
@@ -18,8 +18,49 @@
 #include <catch.hpp>
 
 #include <app/appinfo.h>
+#include <formats/gpx/bitstream.h>
+#include <formats/gpx/documentreader.h>
+#include <formats/gpx/filesystem.h>
 #include <formats/gpx/gpximporter.h>
+#include <fstream>
 #include <score/score.h>
+#include <sstream>
+
+TEST_CASE("Formats/GpxImport/BitStream", "")
+{
+    std::istringstream stream(std::string("\x04\x00\x00\x00\xb5\x3c\xff", 7));
+    Gpx::BitStream input(stream);
+
+    REQUIRE(input.readInt() == 4);
+    REQUIRE(input.readBit());
+    REQUIRE(input.readBits(3) == 3);
+    REQUIRE(input.readBits(4, Gpx::BitStream::Reversed) == 10);
+    REQUIRE(!input.isAtEnd());
+    REQUIRE(input.readBits(8) == 0x3c);
+
+    // Bits past the end of the stream are zero.
+    REQUIRE(input.readBits(12) == 0xff0);
+    REQUIRE(input.getLocation() == 7);
+    REQUIRE(input.isAtEnd());
+}
+
+TEST_CASE("Formats/GpxImport/Decompress", "")
+{
+    std::ifstream file(AppInfo::getAbsolutePath("data/text.gpx").c_str(),
+                       std::ios::binary | std::ios::in);
+    Gpx::FileSystem fs(file);
+
+    boost::string_ref contents = fs.getFileContents("score.gpif");
+    REQUIRE(contents.size() == 10083);
+    REQUIRE(contents.starts_with("<?xml"));
+    REQUIRE(contents.ends_with("</GPIF>\n"));
+
+    // The file can also be modified in place.
+    auto data = fs.getFileData("score.gpif");
+    REQUIRE(data.size() == contents.size());
+    REQUIRE(data.begin() == contents.data());
+    REQUIRE_THROWS(fs.getFileContents("missing.xml"));
+}
 
 TEST_CASE("Formats/GpxImport/Text", "")
 {
@@ -32,4 +73,94 @@ TEST_CASE("Formats/GpxImport/Text", "")
     REQUIRE(system.getTextItems().size() == 1);
     REQUIRE(system.getTextItems()[0].getPosition() == 9);
     REQUIRE(system.getTextItems()[0].getContents() == "foo");
-}
\ No newline at end of file
+}
+
+/// Creates a Guitar Pro 6 document where each bar of each track contains four
+/// quarter notes.
+static std::string createDocument(int num_tracks, int num_bars)
+{
+    const int num_beats = 4;
+    std::ostringstream xml;
+    xml << "<GPIF><Score><Title>Test</Title></Score><Tracks>";
+    for (int track = 0; track < num_tracks; ++track)
+    {
+        xml << "<Track id=\"" << track << "\"><Name>Track " << track
+            << "</Name><GeneralMidi><Program>25</Program></GeneralMidi>"
+            << "</Track>";
+    }
+
+    xml << "</Tracks><MasterBars>";
+    for (int bar = 0; bar < num_bars; ++bar)
+    {
+        xml << "<MasterBar><Key><AccidentalCount>0</AccidentalCount>"
+            << "<Mode>Major</Mode></Key><Time>4/4</Time><Bars>";
+        for (int track = 0; track < num_tracks; ++track)
+            xml << bar * num_tracks + track << " ";
+        xml << "</Bars></MasterBar>";
+    }
+
+    const int total_bars = num_tracks * num_bars;
+    xml << "</MasterBars><Bars>";
+    for (int bar = 0; bar < total_bars; ++bar)
+    {
+        xml << "<Bar id=\"" << bar << "\"><Voices>" << bar
+            << " -1 -1 -1</Voices></Bar>";
+    }
+
+    xml << "</Bars><Voices>";
+    for (int voice = 0; voice < total_bars; ++voice)
+    {
+        xml << "<Voice id=\"" << voice << "\"><Beats>";
+        for (int beat = 0; beat < num_beats; ++beat)
+            xml << voice * num_beats + beat << " ";
+        xml << "</Beats></Voice>";
+    }
+
+    xml << "</Voices><Beats>";
+    for (int beat = 0; beat < total_bars * num_beats; ++beat)
+    {
+        xml << "<Beat id=\"" << beat << "\"><Rhythm ref=\"0\"/><Notes>"
+            << beat << "</Notes></Beat>";
+    }
+
+    xml << "</Beats><Rhythms><Rhythm id=\"0\"><NoteValue>Quarter</NoteValue>"
+        << "</Rhythm></Rhythms><Notes>";
+    for (int note = 0; note < total_bars * num_beats; ++note)
+    {
+        xml << "<Note id=\"" << note << "\"><Properties>"
+            << "<Property name=\"String\"><String>" << note % 6
+            << "</String></Property><Property name=\"Fret\"><Fret>"
+            << note % 12 << "</Fret></Property></Properties></Note>";
+    }
+
+    xml << "</Notes></GPIF>";
+    return xml.str();
+}
+
+TEST_CASE("Formats/GpxImport/DocumentReader", "")
+{
+    std::string xml = createDocument(2, 3);
+    Gpx::DocumentReader reader(&xml[0], xml.size());
+
+    Score score;
+    reader.readScore(score);
+
+    REQUIRE(score.getPlayers().size() == 2);
+    REQUIRE(score.getSystems().size() == 1);
+
+    const System &system = score.getSystems()[0];
+    REQUIRE(system.getBarlines().size() == 4);
+    REQUIRE(system.getStaves()[1].getVoices()[0].getPositions().size() == 12);
+}
+
+TEST_CASE("Formats/GpxImport/DocumentReader/InvalidIds", "")
+{
+    std::string xml = createDocument(1, 1);
+    const std::string rhythm = "<Rhythm ref=\"0\"/>";
+    xml.replace(xml.find(rhythm), rhythm.size(), "<Rhythm ref=\"3\"/>");
+
+    Gpx::DocumentReader reader(&xml[0], xml.size());
+
+    Score score;
+    REQUIRE_THROWS(reader.readScore(score));
+}
@@ -18,8 +18,12 @@
 #include <catch.hpp>
 
 #include <app/appinfo.h>
+#include <formats/fileformat.h>
 #include <formats/guitar_pro/guitarproimporter.h>
+#include <formats/guitar_pro/inputstream.h>
+#include <fstream>
 #include <score/score.h>
+#include <sstream>
 
 static void loadTest(GuitarProImporter &importer, const char *filename,
                      Score &score)
@@ -288,4 +292,38 @@ TEST_CASE("Formats/GuitarPro/IrregularGroups", "")
     REQUIRE(groups[2].getLength() == 6);
     REQUIRE(groups[2].getNotesPlayed() == 6);
     REQUIRE(groups[2].getNotesPlayedOver() == 4);
-}
\ No newline at end of file
+}
+
+/// Returns the contents of a test file.
+static std::string readTestFile(const char *filename)
+{
+    std::ifstream file(AppInfo::getAbsolutePath(filename).c_str(),
+                       std::ios::binary | std::ios::in);
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+TEST_CASE("Formats/GuitarPro/TruncatedFile", "")
+{
+    const std::string data = readTestFile("data/notes.gp5");
+
+    {
+        std::istringstream input(data);
+        Gp::InputStream stream(input);
+        Gp::Document document;
+        REQUIRE_NOTHROW(document.load(stream));
+    }
+
+    {
+        std::istringstream input(data.substr(0, data.size() / 2));
+        Gp::InputStream stream(input);
+        Gp::Document document;
+        REQUIRE_THROWS_AS(document.load(stream), FileFormatException);
+    }
+
+    {
+        std::istringstream input(data.substr(0, 10));
+        REQUIRE_THROWS_AS(Gp::InputStream{ input }, FileFormatException);
+    }
+}
@@ -21,7 +21,9 @@
 #include <formats/powertab/powertabimporter.h>
 #include <formats/powertab_old/powertaboldimporter.h>
 #include <formats/powertab_old/powertabdocument/powertabdocument.h>
+#include <formats/powertab_old/powertabdocument/powertabinputstream.h>
 #include <score/score.h>
+#include <sstream>
 
 static void loadTest(FileFormatImporter &importer, const char *filename,
                      Score &score)
@@ -379,3 +381,18 @@ TEST_CASE("Formats/PowerTabOldImport/MergeMultiBarRests", "")
 
     REQUIRE(score == expected_score);
 }
+
+TEST_CASE("Formats/PowerTabOldImport/InputStream", "")
+{
+    // A 16-bit count, a 32-bit count, and a string that is missing its last
+    // character.
+    std::istringstream input(std::string("\x03\x00\xff\xff\x00\x00\x01\x00"
+                                         "\x03" "ab", 11));
+    PowerTabDocument::PowerTabInputStream stream(input);
+
+    REQUIRE(stream.ReadCount() == 3);
+    REQUIRE(stream.ReadCount() == 0x10000);
+
+    std::string str;
+    REQUIRE_THROWS_AS(stream.ReadMFCString(str), std::ios_base::failure);
+}
@@ -0,0 +1,183 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#include <catch.hpp>
+
+#include <app/appinfo.h>
+#include <app/settingsmanager.h>
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_streambuf.hpp>
+#include <formats/batchconverter.h>
+#include <formats/guitar_pro/guitarproimporter.h>
+#include <formats/powertab/powertabimporter.h>
+#include <formats/powertab_old/powertaboldimporter.h>
+#include <formats/settings.h>
+#include <fstream>
+#include <score/binaryserialization.h>
+#include <score/score.h>
+
+TEST_CASE("Formats/BatchConverter/Convert", "")
+{
+    namespace fs = boost::filesystem;
+    const fs::path dir = fs::temp_directory_path() / fs::unique_path();
+    fs::create_directories(dir);
+
+    std::vector<BatchConverter::Job> jobs;
+    jobs.emplace_back(AppInfo::getAbsolutePath("data/barlines.gp5"),
+                      (dir / "barlines_gp5.pt2").string());
+    jobs.emplace_back(AppInfo::getAbsolutePath("data/barlines.ptb"),
+                      (dir / "barlines_ptb.pt2").string());
+    jobs.emplace_back(AppInfo::getAbsolutePath("data/missing.ptb"),
+                      (dir / "missing.pt2").string());
+    jobs.emplace_back(AppInfo::getAbsolutePath("data/barlines.gp5"),
+                      (dir / "barlines.unknown").string());
+
+    SettingsManager settings_manager;
+    BatchConverter converter(settings_manager);
+
+    std::vector<std::string> finished;
+    std::vector<BatchConverter::Result> results = converter.run(
+        jobs, 2, [&](const BatchConverter::Job &job,
+                     const BatchConverter::Result &) {
+            finished.push_back(job.myDestination);
+        });
+
+    REQUIRE(results.size() == jobs.size());
+    REQUIRE(finished.size() == jobs.size());
+
+    REQUIRE(results[0].mySuccess);
+    REQUIRE(results[1].mySuccess);
+    REQUIRE(!results[2].mySuccess);
+    REQUIRE(!results[2].myError.empty());
+    REQUIRE(!results[3].mySuccess);
+    REQUIRE(!fs::exists(jobs[3].myDestination));
+
+    // The converted files should match the original scores.
+    PowerTabImporter importer;
+    {
+        Score expected, converted;
+        GuitarProImporter().load(jobs[0].mySource, expected);
+        importer.load(jobs[0].myDestination, converted);
+        REQUIRE(converted == expected);
+    }
+    {
+        Score expected, converted;
+        PowerTabOldImporter().load(jobs[1].mySource, expected);
+        importer.load(jobs[1].myDestination, converted);
+        REQUIRE(converted == expected);
+    }
+
+    fs::remove_all(dir);
+}
+
+TEST_CASE("Formats/BatchConverter/BinaryDocuments", "")
+{
+    namespace fs = boost::filesystem;
+    const fs::path dir = fs::temp_directory_path() / fs::unique_path();
+    fs::create_directories(dir);
+
+    std::vector<BatchConverter::Job> jobs;
+    jobs.emplace_back(AppInfo::getAbsolutePath("data/barlines.gp5"),
+                      (dir / "barlines.pt2").string());
+
+    SettingsManager settings_manager;
+    {
+        auto settings = settings_manager.getWriteHandle();
+        settings->set(Settings::SaveBinaryDocuments, true);
+    }
+
+    BatchConverter converter(settings_manager);
+    std::vector<BatchConverter::Result> results = converter.run(jobs, 1);
+    REQUIRE(results[0].mySuccess);
+
+    // The file should contain the binary archive.
+    {
+        std::ifstream file(jobs[0].myDestination,
+                           std::ios::in | std::ios::binary);
+        boost::iostreams::filtering_istreambuf in;
+        in.push(boost::iostreams::gzip_decompressor());
+        in.push(file);
+
+        std::istream input(&in);
+        REQUIRE(ScoreUtils::isBinaryArchive(input));
+    }
+
+    Score expected, converted;
+    GuitarProImporter().load(jobs[0].mySource, expected);
+    PowerTabImporter().load(jobs[0].myDestination, converted);
+    REQUIRE(converted == expected);
+
+    fs::remove_all(dir);
+}
+
+TEST_CASE("Formats/BatchConverter/DuplicateDestinations", "")
+{
+    namespace fs = boost::filesystem;
+    const fs::path dir = fs::temp_directory_path() / fs::unique_path();
+    fs::create_directories(dir);
+
+    // Both files would be written to barlines.pt2.
+    std::vector<BatchConverter::Job> jobs;
+    jobs.emplace_back(AppInfo::getAbsolutePath("data/barlines.gp5"),
+                      (dir / "barlines.pt2").string());
+    jobs.emplace_back(AppInfo::getAbsolutePath("data/barlines.ptb"),
+                      (dir / "barlines.pt2").string());
+    jobs.emplace_back(AppInfo::getAbsolutePath("data/barlines.ptb"),
+                      (dir / "barlines_ptb.pt2").string());
+
+    SettingsManager settings_manager;
+    BatchConverter converter(settings_manager);
+
+    int num_finished = 0;
+    std::vector<BatchConverter::Result> results = converter.run(
+        jobs, 2, [&](const BatchConverter::Job &,
+                     const BatchConverter::Result &) { ++num_finished; });
+
+    REQUIRE(num_finished == 3);
+    REQUIRE(!results[0].mySuccess);
+    REQUIRE(!results[0].myError.empty());
+    REQUIRE(!results[1].mySuccess);
+    REQUIRE(!results[1].myError.empty());
+    REQUIRE(!fs::exists(jobs[0].myDestination));
+    REQUIRE(results[2].mySuccess);
+
+    fs::remove_all(dir);
+}
+
+TEST_CASE("Formats/BatchConverter/RelativePath", "")
+{
+    namespace fs = boost::filesystem;
+    auto relative = [](const std::string &dir, const std::string &file) {
+        return fs::path(BatchConverter::getRelativePath(dir, file));
+    };
+
+    REQUIRE(relative("songs", "songs/a.gp5") == fs::path("a.gp5"));
+    REQUIRE(relative("songs", "songs/rock/a.gp5") == fs::path("rock/a.gp5"));
+    REQUIRE(relative("a/songs", "a/songs/b/c.gp5") == fs::path("b/c.gp5"));
+
+    // A trailing separator or "." components should not affect the result.
+    REQUIRE(relative("songs/", "songs/a.gp5") == fs::path("a.gp5"));
+    REQUIRE(relative("songs/", "songs/rock/a.gp5") == fs::path("rock/a.gp5"));
+    REQUIRE(relative("./songs/./", "./songs/./rock/a.gp5") ==
+            fs::path("rock/a.gp5"));
+    REQUIRE(relative(".", "./a.gp5") == fs::path("a.gp5"));
+
+    // The file must be inside the directory.
+    REQUIRE_THROWS(relative("songs/rock", "songs/a.gp5"));
+    REQUIRE_THROWS(relative("other", "songs/a.gp5"));
+}
@@ -0,0 +1,89 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <midi/midieventlist.h>
+
+TEST_CASE("Midi/MidiEventList/Merge", "")
+{
+    const SystemLocation location(0, 0);
+
+    MidiEventList track1;
+    track1.append(MidiEvent::noteOn(0, 0, 60, 127, location));
+    track1.append(MidiEvent::noteOff(10, 0, 60, location));
+    track1.append(MidiEvent::noteOn(10, 0, 62, 127, location));
+    track1.append(MidiEvent::noteOff(30, 0, 62, location));
+
+    MidiEventList track2;
+    track2.append(MidiEvent::noteOn(5, 1, 40, 127, location));
+    track2.append(MidiEvent::noteOff(10, 1, 40, location));
+    track2.append(MidiEvent::noteOn(40, 1, 41, 127, location));
+
+    // Use delta ticks for the last track.
+    MidiEventList track3;
+    track3.append(MidiEvent::noteOn(10, 2, 50, 127, location));
+    track3.append(MidiEvent::noteOff(15, 2, 50, location));
+    track3.convertToDeltaTicks();
+
+    MidiEventList empty_track;
+
+    const MidiEventList merged =
+        MidiEventList::merge({ &track1, &empty_track, &track2, &track3 });
+    REQUIRE(merged.hasAbsoluteTicks());
+    REQUIRE(merged.size() == 9);
+
+    // Events at the same tick should be ordered by track.
+    const std::vector<std::pair<int, int>> expected = {
+        { 0, 0 }, { 5, 1 }, { 10, 0 }, { 10, 0 }, { 10, 1 },
+        { 10, 2 }, { 15, 2 }, { 30, 0 }, { 40, 1 }
+    };
+
+    auto it = merged.begin();
+    for (auto &&event : expected)
+    {
+        REQUIRE(it->getTicks() == event.first);
+        REQUIRE(it->getChannel() == event.second);
+        ++it;
+    }
+
+    // The order of events within a track should be preserved.
+    REQUIRE(merged.begin()[2].getStatusByte() == MidiEvent::NoteOff);
+    REQUIRE(merged.begin()[3].getStatusByte() == MidiEvent::NoteOn);
+}
+
+TEST_CASE("Midi/MidiEventList/MergeLazily", "")
+{
+    const SystemLocation location(0, 0);
+
+    MidiEventList track1;
+    track1.append(MidiEvent::noteOn(0, 0, 60, 127, location));
+    MidiEventList track2;
+    track2.append(MidiEvent::noteOn(0, 1, 60, 127, location));
+    track2.append(MidiEvent::noteOn(20, 1, 60, 127, location));
+
+    MidiEventMerger merger({ &track1, &track2 });
+    REQUIRE(!merger.isDone());
+    REQUIRE(merger.getEvent().getChannel() == 0);
+    merger.next();
+    REQUIRE(merger.getEvent().getChannel() == 1);
+    REQUIRE(merger.getTicks() == 0);
+    merger.next();
+    REQUIRE(merger.getTicks() == 20);
+    merger.next();
+    REQUIRE(merger.isDone());
+}
@@ -0,0 +1,276 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <midi/midieventcache.h>
+#include <midi/midifile.h>
+#include <score/score.h>
+
+/// Creates a score with several systems, each with a staff for every player
+/// and a few bars of notes.
+static void createScore(Score &score, int num_systems, int num_players)
+{
+    for (int i = 0; i < num_players; ++i)
+    {
+        score.insertPlayer(Player());
+        score.insertInstrument(Instrument());
+    }
+
+    for (int s = 0; s < num_systems; ++s)
+    {
+        System system;
+        system.insertBarline(Barline(8, Barline::SingleBar));
+        system.insertBarline(Barline(16, Barline::SingleBar));
+
+        PlayerChange change(0);
+        for (int i = 0; i < num_players; ++i)
+        {
+            Staff staff(6);
+            for (int p = 0; p < 24; ++p)
+            {
+                if (p == 8 || p == 16)
+                    continue;
+
+                Position pos(p, Position::EighthNote);
+                pos.insertNote(Note((p + i) % 6, p % 12));
+                if (p % 5 == 0)
+                    pos.insertNote(Note((p + i + 3) % 6, 5));
+                staff.getVoices()[0].insertPosition(pos);
+            }
+
+            system.insertStaff(staff);
+            change.insertActivePlayer(i, ActivePlayer(i, i));
+        }
+
+        if (s == 0)
+            system.insertPlayerChange(change);
+
+        score.insertSystem(system);
+    }
+}
+
+static MidiFile::LoadOptions getOptions()
+{
+    MidiFile::LoadOptions options;
+    options.myEnableMetronome = true;
+    options.myRecordPositionChanges = true;
+    return options;
+}
+
+TEST_CASE("Midi/MidiFile/IncrementalLoad", "")
+{
+    Score score;
+    createScore(score, 10, 3);
+
+    // The merged events from a full load.
+    MidiFile full_file;
+    full_file.load(score, getOptions());
+
+    MidiEventList expected;
+    for (MidiEventList &track : full_file.getTracks())
+    {
+        track.convertToAbsoluteTicks();
+        expected.concat(track);
+    }
+    std::stable_sort(expected.begin(), expected.end());
+
+    // Generate the events one bar at a time.
+    MidiFile file;
+    file.beginLoad(score, getOptions());
+
+    MidiEventList events;
+    int num_bars = 0;
+    while (file.loadNextBar())
+    {
+        file.takeCompletedEvents(events);
+        ++num_bars;
+
+        // Events should be available before the entire score is processed.
+        if (num_bars == 3)
+            REQUIRE(events.begin() != events.end());
+    }
+    file.takeCompletedEvents(events);
+
+    REQUIRE(num_bars == 30);
+    REQUIRE(std::distance(events.begin(), events.end()) ==
+            std::distance(expected.begin(), expected.end()));
+
+    auto it = expected.begin();
+    for (const MidiEvent &event : events)
+    {
+        REQUIRE(event.getTicks() == it->getTicks());
+        REQUIRE(event.getData() == it->getData());
+        ++it;
+    }
+}
+
+static void requireSameTracks(const MidiFile &file1, const MidiFile &file2)
+{
+    REQUIRE(file1.getTracks().size() == file2.getTracks().size());
+
+    for (size_t i = 0; i < file1.getTracks().size(); ++i)
+    {
+        const MidiEventList &track1 = file1.getTracks()[i];
+        const MidiEventList &track2 = file2.getTracks()[i];
+        REQUIRE(track1.size() == track2.size());
+
+        auto it = track2.begin();
+        for (const MidiEvent &event : track1)
+        {
+            REQUIRE(event.getTicks() == it->getTicks());
+            REQUIRE(event.getData() == it->getData());
+            ++it;
+        }
+    }
+}
+
+static void loadWithCache(MidiFile &file, const Score &score,
+                          MidiEventCache &cache)
+{
+    file.beginLoad(score, getOptions(), &cache);
+    while (file.loadNextBar())
+        ;
+
+    for (MidiEventList &track : file.getTracks())
+        track.convertToDeltaTicks();
+}
+
+TEST_CASE("Midi/MidiFile/CachedLoad", "")
+{
+    Score score;
+    createScore(score, 10, 3);
+
+    MidiFile expected;
+    expected.load(score, getOptions());
+
+    MidiEventCache cache;
+    MidiFile file1;
+    loadWithCache(file1, score, cache);
+    requireSameTracks(file1, expected);
+    REQUIRE(cache.getHitCount() == std::make_pair(0, 30));
+
+    // Every bar should be reused the second time.
+    MidiFile file2;
+    loadWithCache(file2, score, cache);
+    requireSameTracks(file2, expected);
+    REQUIRE(cache.getHitCount() == std::make_pair(30, 60));
+
+    // Only the bars around the edited system should be regenerated.
+    score.getSystems()[5].getStaves()[0].getVoices()[0].getPositions()[0]
+        .insertNote(Note(5, 7));
+    cache.invalidateSystem(5);
+
+    MidiFile file3;
+    loadWithCache(file3, score, cache);
+    MidiFile expected3;
+    expected3.load(score, getOptions());
+    requireSameTracks(file3, expected3);
+    REQUIRE(cache.getHitCount() == std::make_pair(30 + 21, 90));
+}
+
+TEST_CASE("Midi/MidiFile/StartLocation", "")
+{
+    Score score;
+    createScore(score, 10, 3);
+    for (int i = 0; i < 3; ++i)
+        score.getInstruments()[i].setMidiPreset(10 + i);
+
+    // Set up a tempo, instruments and a held bend before the start location.
+    TempoMarker marker(3);
+    marker.setBeatsPerMinute(90);
+    score.getSystems()[2].insertTempoMarker(marker);
+
+    PlayerChange change(0);
+    for (int i = 0; i < 3; ++i)
+        change.insertActivePlayer(i, ActivePlayer(i, 2 - i));
+    score.getSystems()[3].insertPlayerChange(change);
+    score.updateIndexes(3);
+
+    Note &note =
+        score.getSystems()[4].getStaves()[0].getVoices()[0].getPositions()[1]
+            .getNotes()[0];
+    note.setBend(Bend(Bend::BendAndHold, 4));
+
+    const SystemLocation start(5, 10);
+
+    // Play through the entire score.
+    MidiEventCache cache;
+    MidiFile full_file;
+    full_file.beginLoad(score, getOptions(), &cache);
+    MidiEventList full_events;
+    while (full_file.loadNextBar())
+        ;
+    full_file.takeCompletedEvents(full_events);
+
+    // Start from the bar containing the start location. Each bar should be
+    // generated with the same state as before, and so found in the cache.
+    const std::pair<int, int> initial_hits = cache.getHitCount();
+    MidiFile file;
+    file.beginLoad(score, getOptions(), &cache, start);
+    MidiEventList events;
+    int num_bars = 0;
+    while (file.loadNextBar())
+        ++num_bars;
+    file.takeCompletedEvents(events);
+
+    REQUIRE(num_bars == 14);
+    REQUIRE(cache.getHitCount() ==
+            std::make_pair(initial_hits.first + num_bars,
+                           initial_hits.second + num_bars));
+
+    // The tempo and instruments are set before the bar's events.
+    auto tempo = std::find_if(events.begin(), events.end(),
+                              [](const MidiEvent &event) {
+                                  return event.isTempoChange();
+                              });
+    REQUIRE(tempo != events.end());
+    REQUIRE(tempo->getTicks() == 0);
+    REQUIRE(tempo->getTempo() == 60000000 / 90);
+
+    auto program = std::find_if(events.begin(), events.end(),
+                                [](const MidiEvent &event) {
+                                    return event.isProgramChange();
+                                });
+    REQUIRE(program != events.end());
+    REQUIRE(program->getTicks() == 0);
+    REQUIRE(program->getData()[1] == 12);
+
+    // The events from the start location onwards are the same, apart from
+    // the offset of the timestamps.
+    auto filter = [&](const MidiEventList &list) {
+        std::vector<MidiEvent> filtered;
+        std::copy_if(list.begin(), list.end(), std::back_inserter(filtered),
+                     [&](const MidiEvent &event) {
+                         return !(event.getLocation() < start);
+                     });
+        return filtered;
+    };
+    const std::vector<MidiEvent> expected = filter(full_events);
+    const std::vector<MidiEvent> actual = filter(events);
+    REQUIRE(!actual.empty());
+    REQUIRE(actual.size() == expected.size());
+
+    const int offset = expected.front().getTicks() - actual.front().getTicks();
+    for (size_t i = 0; i < actual.size(); ++i)
+    {
+        REQUIRE(actual[i].getTicks() + offset == expected[i].getTicks());
+        REQUIRE(actual[i].getData() == expected[i].getData());
+    }
+}
@@ -0,0 +1,115 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <painters/layoutcache.h>
+#include <score/score.h>
+
+static void createScore(Score &score)
+{
+    Player player;
+    score.insertPlayer(player);
+
+    for (int i = 0; i < 2; ++i)
+    {
+        System system;
+        Staff staff(6);
+        Position pos(0, Position::EighthNote);
+        pos.insertNote(Note(1, 3));
+        staff.getVoices()[0].insertPosition(pos);
+        system.insertStaff(staff);
+        score.insertSystem(system);
+    }
+}
+
+TEST_CASE("Painters/LayoutCache/Key", "")
+{
+    Score score;
+    createScore(score);
+    const std::vector<bool> visible = { true };
+    const LayoutCache::Key key =
+        LayoutCache::computeKey(score, score.getSystems()[0], 0, visible);
+
+    REQUIRE(LayoutCache::computeKey(score, score.getSystems()[0], 0,
+                                    visible) == key);
+    REQUIRE(LayoutCache::computeKey(score, score.getSystems()[0], 0,
+                                    { false }) != key);
+
+    // The key changes if the system is modified.
+    score.getSystems()[0].insertTextItem(TextItem(2, "Text"));
+    REQUIRE(LayoutCache::computeKey(score, score.getSystems()[0], 0,
+                                    visible) != key);
+    score.getSystems()[0].removeTextItem(TextItem(2, "Text"));
+    REQUIRE(LayoutCache::computeKey(score, score.getSystems()[0], 0,
+                                    visible) == key);
+
+    // The key changes if a player's tuning changes.
+    Tuning tuning;
+    tuning.setCapo(2);
+    score.getPlayers()[0].setTuning(tuning);
+    REQUIRE(LayoutCache::computeKey(score, score.getSystems()[0], 0,
+                                    visible) != key);
+
+    // The second system has the same contents, but a layout cannot be reused
+    // for a different system.
+    Score other;
+    createScore(other);
+    const LayoutCache::Key key1 =
+        LayoutCache::computeKey(other, other.getSystems()[0], 0, visible);
+    const LayoutCache::Key key2 =
+        LayoutCache::computeKey(other, other.getSystems()[1], 0, visible);
+    REQUIRE(key1.myContentHash == key2.myContentHash);
+    REQUIRE(key1 != key2);
+}
+
+static LayoutCache::Key makeKey(size_t hash, const void *address = nullptr)
+{
+    LayoutCache::Key key;
+    key.myContentHash = hash;
+    key.myAddresses.push_back(address);
+    return key;
+}
+
+TEST_CASE("Painters/LayoutCache/FindAndInsert", "")
+{
+    LayoutCache cache;
+    LayoutCache::SystemLayout layout;
+
+    REQUIRE(!cache.find(0, makeKey(1), layout));
+    cache.insert(0, makeKey(1), LayoutCache::SystemLayout(2));
+    REQUIRE(cache.find(0, makeKey(1), layout));
+    REQUIRE(layout.size() == 2);
+
+    // A different key or system.
+    REQUIRE(!cache.find(0, makeKey(2), layout));
+    REQUIRE(!cache.find(1, makeKey(1), layout));
+
+    // The same contents, but at a different address.
+    int value = 0;
+    REQUIRE(!cache.find(0, makeKey(1, &value), layout));
+
+    // Replace the layout for the system.
+    cache.insert(0, makeKey(2), LayoutCache::SystemLayout(3));
+    REQUIRE(!cache.find(0, makeKey(1), layout));
+    REQUIRE(cache.find(0, makeKey(2), layout));
+    REQUIRE(layout.size() == 3);
+    REQUIRE(cache.getHitCount() == std::make_pair(2, 7));
+
+    cache.clear();
+    REQUIRE(!cache.find(0, makeKey(2), layout));
+}
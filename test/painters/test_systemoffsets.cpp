@@ -0,0 +1,62 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <painters/systemoffsets.h>
+
+TEST_CASE("Painters/SystemOffsets/Positions", "")
+{
+    SystemOffsets offsets(10);
+    offsets.reset({ 100, 200, 50, 75, 30 });
+
+    REQUIRE(offsets.getNumSystems() == 5);
+    REQUIRE(offsets.getTop(0) == 0);
+    REQUIRE(offsets.getTop(1) == 110);
+    REQUIRE(offsets.getTop(2) == 320);
+    REQUIRE(offsets.getBottom(2) == 370);
+    REQUIRE(offsets.getTop(4) == 465);
+    REQUIRE(offsets.getTotalHeight() == 495);
+
+    offsets.setHeight(1, 150);
+    REQUIRE(offsets.getHeight(1) == 150);
+    REQUIRE(offsets.getTop(1) == 110);
+    REQUIRE(offsets.getTop(2) == 270);
+    REQUIRE(offsets.getTop(4) == 415);
+    REQUIRE(offsets.getTotalHeight() == 445);
+}
+
+TEST_CASE("Painters/SystemOffsets/FindSystem", "")
+{
+    SystemOffsets offsets(10);
+    offsets.reset({ 100, 200, 50 });
+
+    REQUIRE(offsets.findSystem(-5) == 0);
+    REQUIRE(offsets.findSystem(0) == 0);
+    REQUIRE(offsets.findSystem(100) == 0);
+    // Within the spacing after the first system.
+    REQUIRE(offsets.findSystem(105) == 1);
+    REQUIRE(offsets.findSystem(110) == 1);
+    REQUIRE(offsets.findSystem(310) == 1);
+    REQUIRE(offsets.findSystem(311) == 2);
+    REQUIRE(offsets.findSystem(370) == 2);
+    REQUIRE(offsets.findSystem(371) == 3);
+
+    offsets.reset({});
+    REQUIRE(offsets.findSystem(0) == 0);
+    REQUIRE(offsets.getTotalHeight() == 0);
+}
@@ -0,0 +1,91 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <painters/verticallayout.h>
+#include <random>
+#include <vector>
+
+/// The original implementation of VerticalLayout::addBox(), which stores the
+/// height at every position.
+static int addBoxReference(std::vector<int> &heights, int left, int right,
+                           int height)
+{
+    heights.resize(std::max<size_t>(heights.size(), right + 1));
+    const int newHeight =
+        *std::max_element(heights.begin() + left, heights.begin() + right) +
+        height;
+    std::fill_n(heights.begin() + left, right - left, newHeight);
+    return newHeight;
+}
+
+TEST_CASE("Painters/VerticalLayout/AddBox", "")
+{
+    VerticalLayout layout;
+
+    REQUIRE(layout.addBox(2, 5, 1) == 1);
+    REQUIRE(layout.addBox(0, 2, 1) == 1);
+    // Overlaps both of the previous boxes.
+    REQUIRE(layout.addBox(1, 3, 2) == 3);
+    // Adjacent to the first box.
+    REQUIRE(layout.addBox(5, 8, 1) == 1);
+    REQUIRE(layout.addBox(4, 6, 1) == 2);
+    REQUIRE(layout.addBox(0, 10, 1) == 4);
+}
+
+TEST_CASE("Painters/VerticalLayout/EmptyBox", "")
+{
+    VerticalLayout layout;
+    REQUIRE(layout.addBox(3, 3, 1) == 1);
+    // An empty box does not take up any space.
+    REQUIRE(layout.addBox(3, 3, 1) == 1);
+    REQUIRE(layout.addBox(0, 10, 1) == 1);
+
+    REQUIRE(layout.addBox(2, 5, 2) == 3);
+    REQUIRE(layout.addBox(2, 2, 1) == 4);
+    REQUIRE(layout.addBox(5, 5, 1) == 2);
+}
+
+/// Adds random boxes, where many of them overlap, and checks that they are
+/// placed in the same locations as with the original implementation.
+static void checkRandomBoxes(int width, int numBoxes, int maxBoxWidth)
+{
+    std::mt19937 generator(width);
+    std::uniform_int_distribution<int> position(0, width);
+    std::uniform_int_distribution<int> boxWidth(0, maxBoxWidth);
+    std::uniform_int_distribution<int> boxHeight(1, 3);
+
+    VerticalLayout layout;
+    std::vector<int> heights;
+    for (int i = 0; i < numBoxes; ++i)
+    {
+        const int left = position(generator);
+        const int right = std::min(width, left + boxWidth(generator));
+        const int height = boxHeight(generator);
+
+        REQUIRE(layout.addBox(left, right, height) ==
+                addBoxReference(heights, left, right, height));
+    }
+}
+
+TEST_CASE("Painters/VerticalLayout/RandomBoxes", "")
+{
+    checkRandomBoxes(50, 1000, 10);
+    checkRandomBoxes(500, 1000, 100);
+}
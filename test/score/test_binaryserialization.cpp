@@ -0,0 +1,143 @@
+/*
+  * Copyright (C) 2015 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <score/binaryserialization.h>
+#include <score/score.h>
+#include <sstream>
+
+/// Creates a score with a variety of notes and symbols in each system.
+static void createScore(Score &score, int num_systems)
+{
+    ScoreInfo info;
+    SongData data;
+    data.setTitle("Title");
+    data.setArtist("Artist");
+    data.setLyrics("Some lyrics\nwith several lines");
+    info.setSongData(data);
+    score.setScoreInfo(info);
+
+    Player player;
+    player.setDescription("Player 1");
+    score.insertPlayer(player);
+    score.insertInstrument(Instrument());
+
+    ViewFilter filter;
+    filter.addRule(FilterRule(FilterRule::PLAYER_NAME, "Player 1"));
+    score.insertViewFilter(filter);
+
+    for (int s = 0; s < num_systems; ++s)
+    {
+        System system;
+        system.insertBarline(Barline(8, Barline::RepeatStart));
+        system.insertBarline(Barline(16, Barline::RepeatEnd, 2));
+        system.insertTempoMarker(TempoMarker(4));
+        system.insertTextItem(TextItem(3, "Text"));
+
+        Staff staff(6);
+        for (int p = 0; p < 24; ++p)
+        {
+            if (p == 8 || p == 16)
+                continue;
+
+            Position pos(p, Position::SixteenthNote);
+            pos.setProperty(Position::Vibrato, p % 3 == 0);
+
+            Note note(p % 6, p % 24);
+            note.setProperty(Note::HammerOnOrPullOff, p % 2 == 0);
+            if (p % 7 == 0)
+                note.setBend(Bend(Bend::NormalBend, 4));
+            pos.insertNote(note);
+
+            staff.getVoices()[0].insertPosition(pos);
+        }
+
+        system.insertStaff(staff);
+        score.insertSystem(system);
+    }
+}
+
+TEST_CASE("Score/BinarySerialization/Score", "")
+{
+    Score score;
+    createScore(score, 5);
+
+    std::ostringstream output;
+    ScoreUtils::saveBinary(output, "score", score);
+
+    std::istringstream input(output.str());
+    REQUIRE(ScoreUtils::isBinaryArchive(input));
+
+    Score copy;
+    ScoreUtils::loadBinary(input, "score", copy);
+    REQUIRE(copy == score);
+}
+
+TEST_CASE("Score/BinarySerialization/InvalidData", "")
+{
+    Score score;
+    createScore(score, 1);
+
+    std::ostringstream output;
+    ScoreUtils::saveBinary(output, "score", score);
+    const std::string data = output.str();
+
+    // JSON data is not a binary archive.
+    std::istringstream json_input("{\"version\": 3}");
+    REQUIRE(!ScoreUtils::isBinaryArchive(json_input));
+    REQUIRE_THROWS(ScoreUtils::loadBinary(json_input, "score", score));
+
+    // Unexpected root name.
+    {
+        std::istringstream input(data);
+        REQUIRE_THROWS(ScoreUtils::loadBinary(input, "clipboard", score));
+    }
+
+    // Truncated data.
+    {
+        std::istringstream input(data.substr(0, data.size() / 2));
+        REQUIRE_THROWS(ScoreUtils::loadBinary(input, "score", score));
+    }
+}
+
+TEST_CASE("Score/BinarySerialization/HashContents", "")
+{
+    Score score;
+    createScore(score, 2);
+
+    const System &system = score.getSystems()[0];
+    System copy(system);
+    REQUIRE(ScoreUtils::hashContents(copy) ==
+            ScoreUtils::hashContents(system));
+    // The second system has the same contents.
+    REQUIRE(ScoreUtils::hashContents(score.getSystems()[1]) ==
+            ScoreUtils::hashContents(system));
+
+    copy.insertTextItem(TextItem(5, "Text"));
+    REQUIRE(ScoreUtils::hashContents(copy) !=
+            ScoreUtils::hashContents(system));
+
+    Staff &staff = copy.getStaves()[0];
+    REQUIRE(ScoreUtils::hashContents(staff) ==
+            ScoreUtils::hashContents(system.getStaves()[0]));
+
+    staff.getVoices()[0].getPositions()[0].setDurationType(
+        Position::EighthNote);
+    REQUIRE(ScoreUtils::hashContents(staff) !=
+            ScoreUtils::hashContents(system.getStaves()[0]));
+}
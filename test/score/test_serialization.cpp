@@ -0,0 +1,186 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <array>
+#include <boost/optional.hpp>
+#include <score/serialization.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+struct TestObject
+{
+    TestObject() : myInt(0), myArray{ { 0, 0 } } {}
+
+    template <class Archive>
+    void serialize(Archive &ar, const FileVersion /*version*/)
+    {
+        ar("int", myInt);
+        ar("text", myText);
+        ar("list", myList);
+        ar("optional", myOptional);
+        ar("array", myArray);
+    }
+
+    int myInt;
+    std::string myText;
+    std::vector<int> myList;
+    boost::optional<int> myOptional;
+    std::array<int, 2> myArray;
+};
+}
+
+static TestObject loadObject(const std::string &json)
+{
+    std::istringstream input("{\"version\": 3, \"object\": " + json + "}");
+    TestObject obj;
+    ScoreUtils::load(input, "object", obj);
+    return obj;
+}
+
+/// Loads an object whose "text" member is the given JSON string.
+static std::string loadText(const std::string &text)
+{
+    return loadObject("{\"int\": 0, \"text\": " + text +
+                      ", \"list\": [], \"optional\": null, "
+                      "\"array\": {\"0\": 0, \"1\": 0}}").myText;
+}
+
+TEST_CASE("Score/Serialization/Values", "")
+{
+    const TestObject obj = loadObject(
+        "{\"int\": -42, \"text\": \"abc\", \"list\": [1, 2, 3], "
+        "\"optional\": 7, \"array\": {\"0\": 4, \"1\": 5}}");
+
+    REQUIRE(obj.myInt == -42);
+    REQUIRE(obj.myText == "abc");
+    REQUIRE(obj.myList == std::vector<int>({ 1, 2, 3 }));
+    REQUIRE(obj.myOptional.get_value_or(0) == 7);
+    REQUIRE(obj.myArray[0] == 4);
+    REQUIRE(obj.myArray[1] == 5);
+}
+
+TEST_CASE("Score/Serialization/Escapes", "")
+{
+    REQUIRE(loadText("\"\"") == "");
+    REQUIRE(loadText("\"a\\\"b\\\\c\\/d\"") == "a\"b\\c/d");
+    REQUIRE(loadText("\"\\b\\f\\n\\r\\t\"") == "\b\f\n\r\t");
+
+    // Unicode escapes are converted to UTF-8.
+    REQUIRE(loadText("\"\\u0041\\u00e9\\u20AC\"") == "A\xC3\xA9\xE2\x82\xAC");
+    // UTF-8 data is copied unchanged.
+    REQUIRE(loadText("\"\xC3\xA9\"") == "\xC3\xA9");
+}
+
+TEST_CASE("Score/Serialization/SurrogatePairs", "")
+{
+    REQUIRE(loadText("\"\\ud83c\\udfb8\"") == "\xF0\x9F\x8E\xB8");
+    REQUIRE(loadText("\"x\\uD834\\uDD1Ey\"") == "x\xF0\x9D\x84\x9Ey");
+
+    // A high surrogate must be followed by a low surrogate.
+    REQUIRE_THROWS(loadText("\"\\ud83c\""));
+    REQUIRE_THROWS(loadText("\"\\ud83cx\""));
+    REQUIRE_THROWS(loadText("\"\\ud83c\\u0041\""));
+    // A low surrogate cannot appear by itself.
+    REQUIRE_THROWS(loadText("\"\\udfb8\""));
+}
+
+TEST_CASE("Score/Serialization/Whitespace", "")
+{
+    const TestObject obj = loadObject(
+        "\n\t{ \"int\"\r\n:\t12 ,\"text\":\"a b\",\n  \"list\" : [ 1 ,2\t,3 ] ,"
+        "\"optional\"  :  null  , \"array\" : { \"0\" : 1 , \"1\" : 2 } \n}");
+
+    REQUIRE(obj.myInt == 12);
+    REQUIRE(obj.myText == "a b");
+    REQUIRE(obj.myList == std::vector<int>({ 1, 2, 3 }));
+    REQUIRE(!obj.myOptional.is_initialized());
+    REQUIRE(obj.myArray[1] == 2);
+}
+
+TEST_CASE("Score/Serialization/UnknownMembers", "")
+{
+    // Members that are not read by the object should be skipped, wherever
+    // they appear and whatever their type.
+    const TestObject obj = loadObject(
+        "{\"before\": {\"a\": [1, {\"b\": {}}], \"c\": \"}\"}, \"int\": 3, "
+        "\"float\": -1.5e+3, \"text\": \"t\", \"flags\": [true, false, null], "
+        "\"list\": [], \"string\": \"\\\"\\u0041\", \"optional\": null, "
+        "\"empty\": [], \"array\": {\"extra\": {}, \"0\": 1, \"1\": 2, "
+        "\"3\": 0}, \"after\": {}}");
+
+    REQUIRE(obj.myInt == 3);
+    REQUIRE(obj.myText == "t");
+    REQUIRE(obj.myList.empty());
+    REQUIRE(obj.myArray[0] == 1);
+    REQUIRE(obj.myArray[1] == 2);
+}
+
+TEST_CASE("Score/Serialization/MalformedInput", "")
+{
+    const std::string valid =
+        "{\"int\": 1, \"text\": \"abc\", \"list\": [1, 2], "
+        "\"optional\": null, \"array\": {\"0\": 1, \"1\": 2}}";
+    REQUIRE_NOTHROW(loadObject(valid));
+
+    // Truncated data.
+    for (size_t i = 0; i < valid.size(); ++i)
+        REQUIRE_THROWS(loadObject(valid.substr(0, i)));
+
+    // Missing punctuation.
+    REQUIRE_THROWS(loadObject("{\"int\": 1 \"text\": \"abc\", \"list\": [], "
+                              "\"optional\": null, \"array\": {\"0\": 1, "
+                              "\"1\": 2}}"));
+    REQUIRE_THROWS(loadObject("{\"int\" 1, \"text\": \"abc\", \"list\": [], "
+                              "\"optional\": null, \"array\": {\"0\": 1, "
+                              "\"1\": 2}}"));
+    REQUIRE_THROWS(loadObject("{\"int\": 1, \"text\": \"abc\", \"list\": [1 2], "
+                              "\"optional\": null, \"array\": {\"0\": 1, "
+                              "\"1\": 2}}"));
+    REQUIRE_THROWS(loadObject("{\"int\": 1, \"text\": \"abc\", \"list\": [1,], "
+                              "\"optional\": null, \"array\": {\"0\": 1, "
+                              "\"1\": 2}}"));
+
+    // Missing members.
+    REQUIRE_THROWS(loadObject("{\"int\": 1, \"list\": [], \"optional\": null, "
+                              "\"array\": {\"0\": 1, \"1\": 2}}"));
+    REQUIRE_THROWS(loadObject("{\"int\": 1, \"text\": \"abc\", \"list\": [], "
+                              "\"optional\": null, \"array\": {\"0\": 1}}"));
+
+    // Values of the wrong type.
+    REQUIRE_THROWS(loadObject("{\"int\": \"1\", \"text\": \"abc\", "
+                              "\"list\": [], \"optional\": null, "
+                              "\"array\": {\"0\": 1, \"1\": 2}}"));
+    REQUIRE_THROWS(loadObject("{\"int\": 1.5, \"text\": \"abc\", "
+                              "\"list\": [], \"optional\": null, "
+                              "\"array\": {\"0\": 1, \"1\": 2}}"));
+    REQUIRE_THROWS(loadObject("{\"int\": 99999999999, \"text\": \"abc\", "
+                              "\"list\": [], \"optional\": null, "
+                              "\"array\": {\"0\": 1, \"1\": 2}}"));
+    REQUIRE_THROWS(loadObject("{\"int\": 1, \"text\": \"abc\", \"list\": [], "
+                              "\"optional\": nul, \"array\": {\"0\": 1, "
+                              "\"1\": 2}}"));
+
+    // Invalid escape sequences.
+    REQUIRE_THROWS(loadText("\"\\x\""));
+    REQUIRE_THROWS(loadText("\"\\u12G4\""));
+    REQUIRE_THROWS(loadText("\"\\u12\""));
+}
@@ -20,6 +20,7 @@
 
 #include <catch.hpp>
 
+#include <score/binaryserialization.h>
 #include <score/serialization.h>
 #include <sstream>
 
@@ -38,6 +39,16 @@ namespace Serialization {
         ScoreUtils::load(input, name, copy);
 
         REQUIRE(original == copy);
+
+        // The binary format should also round-trip.
+        std::ostringstream binary_output;
+        ScoreUtils::saveBinary(binary_output, name, original);
+
+        T binary_copy;
+        std::istringstream binary_input(binary_output.str());
+        ScoreUtils::loadBinary(binary_input, name, binary_copy);
+
+        REQUIRE(original == binary_copy);
     }
 }
 
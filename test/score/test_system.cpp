@@ -18,6 +18,7 @@
 #include <catch.hpp>
 
 #include <score/system.h>
+#include "test_serialization.h"
 
 TEST_CASE("Score/System/Staves", "")
 {
@@ -203,3 +204,18 @@ TEST_CASE("Score/System/TextItems", "")
     REQUIRE(system.getTextItems().size() == 1);
     REQUIRE(system.getTextItems()[0] == text1);
 }
+
+TEST_CASE("Score/System/Serialization", "")
+{
+    System system;
+    system.insertStaff(Staff(6));
+    system.insertTextItem(TextItem(3, "Text"));
+
+    // A player change with no active players is written as an empty object,
+    // followed by the system's other members.
+    PlayerChange change;
+    change.setPosition(5);
+    system.insertPlayerChange(change);
+
+    Serialization::test("system", system);
+}
@@ -33,6 +33,26 @@ TEST_CASE("Score/Utils/FindByPosition", "")
     REQUIRE(*ScoreUtils::findByPosition(system.getBarlines(), 42) == barline);
 }
 
+TEST_CASE("Score/Utils/FindByPosition/Voice", "")
+{
+    // Insert every other position out of order.
+    Voice voice;
+    for (int i = 100; i >= 0; i -= 2)
+        voice.insertPosition(Position(i));
+
+    REQUIRE(ScoreUtils::isSortedByPosition(voice.getPositions()));
+    REQUIRE(ScoreUtils::findIndexByPosition(voice.getPositions(), 0) == 0);
+    REQUIRE(ScoreUtils::findIndexByPosition(voice.getPositions(), 50) == 25);
+    REQUIRE(ScoreUtils::findIndexByPosition(voice.getPositions(), 100) == 50);
+    REQUIRE(ScoreUtils::findIndexByPosition(voice.getPositions(), 51) == -1);
+    REQUIRE(ScoreUtils::findIndexByPosition(voice.getPositions(), 101) == -1);
+    REQUIRE(ScoreUtils::findIndexByPosition(voice.getPositions(), -1) == -1);
+
+    const Position *pos = ScoreUtils::findByPosition(voice.getPositions(), 42);
+    REQUIRE(pos);
+    REQUIRE(pos->getPosition() == 42);
+}
+
 TEST_CASE("Score/Utils/GetCurrentPlayers", "")
 {
     Score score;
@@ -47,3 +67,62 @@ TEST_CASE("Score/Utils/GetCurrentPlayers", "")
     REQUIRE(ScoreUtils::getCurrentPlayers(score, 0, 7));
     REQUIRE(ScoreUtils::getCurrentPlayers(score, 1, 0));
 }
+
+TEST_CASE("Score/Utils/GetCurrentPlayers/MultipleSystems", "")
+{
+    Score score;
+    for (int i = 0; i < 4; ++i)
+        score.insertSystem(System());
+
+    PlayerChange change1(3);
+    PlayerChange change2(9);
+    score.getSystems()[1].insertPlayerChange(change1);
+    score.getSystems()[1].insertPlayerChange(change2);
+    score.updateIndexes(1);
+
+    REQUIRE(!ScoreUtils::getCurrentPlayers(score, 0, 100));
+    REQUIRE(!ScoreUtils::getCurrentPlayers(score, 1, 2));
+    REQUIRE(*ScoreUtils::getCurrentPlayers(score, 1, 3) == change1);
+    REQUIRE(*ScoreUtils::getCurrentPlayers(score, 1, 8) == change1);
+    REQUIRE(*ScoreUtils::getCurrentPlayers(score, 1, 9) == change2);
+    REQUIRE(*ScoreUtils::getCurrentPlayers(score, 3, 0) == change2);
+
+    // Inserting and removing systems should keep the index up to date.
+    score.insertSystem(System(), 0);
+    REQUIRE(!ScoreUtils::getCurrentPlayers(score, 1, 100));
+    REQUIRE(*ScoreUtils::getCurrentPlayers(score, 3, 0) == change2);
+
+    score.removeSystem(2);
+    REQUIRE(!ScoreUtils::getCurrentPlayers(score, 3, 0));
+}
+
+TEST_CASE("Score/Utils/BarNumbers", "")
+{
+    Score score;
+    System system;
+    system.insertBarline(Barline(4, Barline::SingleBar));
+    score.insertSystem(system);
+    score.insertSystem(System());
+    score.insertSystem(system);
+
+    const BarNumberIndex &index = score.getBarNumberIndex();
+    REQUIRE(index.getNumBars() == 5);
+    REQUIRE(index.getFirstBarNumber(0) == 1);
+    REQUIRE(index.getFirstBarNumber(1) == 3);
+    REQUIRE(index.getFirstBarNumber(2) == 4);
+
+    REQUIRE(index.findBar(score, 2) == SystemLocation(0, 4));
+    REQUIRE(index.findBar(score, 3) == SystemLocation(1, 0));
+    REQUIRE(index.findBar(score, 5) == SystemLocation(2, 4));
+    REQUIRE_THROWS(index.findBar(score, 0));
+    REQUIRE_THROWS(index.findBar(score, 6));
+
+    score.getSystems()[1].insertBarline(Barline(8, Barline::SingleBar));
+    score.updateIndexes(1);
+    REQUIRE(index.getNumBars() == 6);
+    REQUIRE(index.getFirstBarNumber(2) == 5);
+
+    score.removeSystem(0);
+    REQUIRE(index.getNumBars() == 4);
+    REQUIRE(index.findBar(score, 2) == SystemLocation(0, 8));
+}
@@ -67,3 +67,80 @@ TEST_CASE("Score/ViewFilter/Serialization", "")
 
     Serialization::test("filter", filter);
 }
+
+TEST_CASE("Score/ViewFilter/Visibility", "")
+{
+    Score score;
+
+    PowerTabImporter importer;
+    importer.load(AppInfo::getAbsolutePath("data/test_viewfilter.pt2"), score);
+
+    ViewFilter filter;
+    filter.addRule(FilterRule(FilterRule::PLAYER_NAME, "Player 1"));
+    score.insertViewFilter(filter);
+
+    const ViewFilter &cached_filter = score.getViewFilters().back();
+    REQUIRE(cached_filter.accept(score, 0, 0));
+    REQUIRE(!cached_filter.accept(score, 0, 1));
+    REQUIRE(!cached_filter.accept(score, 0, 2));
+
+    // The visibility should be recomputed after the players are edited.
+    score.getPlayers()[1].setDescription("Player 1");
+    score.updateIndexes(0);
+    REQUIRE(cached_filter.accept(score, 0, 0));
+    REQUIRE(cached_filter.accept(score, 0, 1));
+    REQUIRE(!cached_filter.accept(score, 0, 2));
+}
+
+TEST_CASE("Score/ViewFilter/Visibility/EditRules", "")
+{
+    Score score;
+
+    PowerTabImporter importer;
+    importer.load(AppInfo::getAbsolutePath("data/test_viewfilter.pt2"), score);
+
+    ViewFilter filter;
+    filter.addRule(FilterRule(FilterRule::PLAYER_NAME, "Player 1"));
+    score.insertViewFilter(filter);
+
+    ViewFilter &cached_filter = score.getViewFilters().back();
+    REQUIRE(cached_filter.accept(score, 0, 0));
+    REQUIRE(!cached_filter.accept(score, 0, 1));
+
+    // Editing a rule should discard the cached visibility.
+    cached_filter.setRule(0, FilterRule(FilterRule::PLAYER_NAME, "Player 2"));
+    REQUIRE(!cached_filter.accept(score, 0, 0));
+    REQUIRE(cached_filter.accept(score, 0, 1));
+
+    // A copy of the filter should not use the visibility that was computed
+    // for another score.
+    score.updateIndexes(0);
+    const ViewFilter copy(cached_filter);
+    Score other_score;
+    importer.load(AppInfo::getAbsolutePath("data/test_viewfilter.pt2"),
+                  other_score);
+    other_score.getPlayers()[0].setDescription("Player 2");
+    REQUIRE(copy.accept(other_score, 0, 0));
+    REQUIRE(copy.accept(other_score, 0, 1));
+}
+
+TEST_CASE("Score/ViewFilter/LoadPlayerNameRule", "")
+{
+    Score score;
+
+    PowerTabImporter importer;
+    importer.load(AppInfo::getAbsolutePath("data/test_viewfilter.pt2"), score);
+
+    // The regular expression should be usable after loading the rule.
+    std::ostringstream output;
+    ScoreUtils::save(output, "rule",
+                     FilterRule(FilterRule::PLAYER_NAME, "Player [12]"));
+
+    FilterRule rule;
+    std::istringstream input(output.str());
+    ScoreUtils::load(input, "rule", rule);
+
+    REQUIRE(rule.accept(score, 0, 0));
+    REQUIRE(rule.accept(score, 0, 1));
+    REQUIRE(!rule.accept(score, 0, 2));
+}